@@ -0,0 +1,79 @@
+#pragma once
+
+#include "core/PackedPosition.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Chess {
+namespace AI {
+
+namespace Nnue {
+struct Network;
+}
+
+// Что считается для каждой позиции
+enum class BatchMode {
+    Static,         // Статическая оценка
+    Quiescence      // Quiescence-поиск с полным окном (как лист MCTS)
+};
+
+struct BatchOptions {
+    int threads = 1;
+    BatchMode mode = BatchMode::Static;
+    std::shared_ptr<const Nnue::Network> network;   // nullptr - классическая оценка
+};
+
+// Массовая оценка позиций для разметки датасетов. Пул потоков живет вместе с
+// объектом; у каждого потока своя доска, движок и кеши (пешечный, оценок),
+// они переиспользуются от позиции к позиции и от пакета к пакету. На позицию
+// приходится только загрузка доски из PackedPosition и сама оценка.
+class BatchEvaluator {
+public:
+    explicit BatchEvaluator(const BatchOptions& options);
+    ~BatchEvaluator();
+
+    BatchEvaluator(const BatchEvaluator&) = delete;
+    BatchEvaluator& operator=(const BatchEvaluator&) = delete;
+
+    // Оценки с точки зрения стороны на ходу: scores[i] - для positions[i].
+    // Вызывающий поток работает наравне с пулом; вызовы не должны пересекаться.
+    void evaluate(const PackedPosition* positions, size_t count, int16_t* scores);
+
+    // Файл записей PackedPosition -> файл int16 оценок в том же порядке;
+    // count - число позиций. Оба файла отображаются в память (POSIX mmap).
+    bool evaluateFile(const std::string& inputPath, const std::string& outputPath, size_t& count,
+                      std::string& error);
+
+    const BatchOptions& options() const { return options_; }
+
+private:
+    struct Worker;
+
+    BatchOptions options_;
+    std::vector<std::unique_ptr<Worker>> workers_;  // [0] - вызывающего потока
+    std::vector<std::thread> threads_;
+
+    // Текущий пакет: потоки разбирают его кусками по CHUNK_SIZE позиций
+    const PackedPosition* positions_ = nullptr;
+    int16_t* scores_ = nullptr;
+    size_t count_ = 0;
+    std::atomic<size_t> next_{0};
+
+    std::mutex mutex_;
+    std::condition_variable wake_;      // Новый пакет или остановка
+    std::condition_variable done_;      // Поток пула закончил пакет
+    uint64_t generation_ = 0;
+    int pending_ = 0;                   // Потоков пула, еще работающих над пакетом
+    bool stop_ = false;
+
+    void threadLoop(int index);
+    void process(Worker& worker);
+};
+
+}} // namespace Chess::AI
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <ostream>
+
+namespace Chess {
+namespace AI {
+
+// Результат бенчмарка
+struct BenchResult {
+    uint64_t nodes = 0;         // Подпись: суммарное число узлов
+    double timeSpent = 0.0;
+    uint64_t nps = 0;
+};
+
+// Детерминированный поиск на глубину depth по фиксированному набору позиций.
+// Число узлов меняется при любом функциональном изменении поиска или оценки
+// и не меняется при чисто оптимизационных - так их и отличаем.
+// Если out задан, туда печатается ход и число узлов по каждой позиции.
+// С deterministic = false поиск многопоточный (подпись не воспроизводится):
+// так измеряется влияние политики закрепления потоков на скорость.
+BenchResult runBench(int depth = 5, std::ostream* out = nullptr, bool deterministic = true);
+
+// Проверка ядер материала и PSQT классической оценки
+struct EvalBenchResult {
+    int positions = 0;
+    bool kernelsExact = true;       // Все ядра дают ту же оценку, что и эталон
+};
+
+// Позиции бенчмарка и случайные партии из них: оценка с каждым ядром
+// (эталон, скалярное по таблице, AVX2) сверяется с эталонной бит в бит;
+// скорость оценки и NPS поиска на глубину depth с каждым ядром.
+EvalBenchResult runEvalBench(int depth = 5, std::ostream* out = nullptr);
+
+namespace Nnue {
+struct Network;
+}
+
+// Сравнение нейросетевой оценки с классической
+struct NnueBenchResult {
+    int positions = 0;
+    double meanAbsDiff = 0.0;       // Средняя |NNUE - классика|, сантипешки
+    double correlation = 0.0;       // Корреляция Пирсона оценок
+    double signAgreement = 0.0;     // Доля позиций, где оценки одного знака
+    bool incrementalExact = true;   // Аккумулятор после ходов = пересчет с нуля
+    bool kernelsExact = true;       // Все наборы инструкций дают одно и то же
+    uint64_t classicNps = 0;
+    uint64_t nnueNps = 0;
+};
+
+// Позиции бенчмарка и случайные партии из них (с фиксированным зерном):
+// точность относительно классической оценки, совпадение инкрементального
+// и полного пересчета, совпадение ядер AVX2/SSE4.1/scalar и скорость оценки
+// каждого из них, NPS поиска на глубину depth с обеими оценками.
+NnueBenchResult runNnueBench(std::shared_ptr<const Nnue::Network> network, int depth = 5,
+                             std::ostream* out = nullptr);
+
+}} // namespace Chess::AI
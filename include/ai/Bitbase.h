@@ -0,0 +1,30 @@
+#pragma once
+
+#include "core/Board.h"
+#include "core/Types.h"
+#include <cstddef>
+
+namespace Chess {
+namespace AI {
+namespace Bitbases {
+
+// Битовая база KPK (король с пешкой против короля): бит на позицию - выигрыш
+// или ничья при точной игре. Строится ретроградным анализом при запуске
+// программы, до main; 2 стороны хода x 24 поля пешки (вертикали a-d, 2-7
+// горизонтали, остальное - отражение) x 64 x 64 поля королей = 24 КБ.
+
+// Выигрывает ли сторона strong с пешкой pawn. Клетки - как на доске, для
+// любого цвета сильной стороны; sideToMove - чей ход.
+bool probeKPK(Color strong, Square strongKing, Square pawn, Square weakKing, Color sideToMove);
+
+// Материал на доске - KPK; strong - сторона с пешкой
+bool isKPK(const Board& board, Color& strong);
+
+// Выигрыш для стороны с пешкой в позиции KPK (isKPK(board) == true)
+bool probeKPK(const Board& board, Color strong);
+
+// Размер базы в байтах и время ее построения
+size_t kpkSizeBytes();
+double kpkGenerationMs();
+
+}}} // namespace Chess::AI::Bitbases
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "core/Board.h"
+#include "core/Types.h"
+
+namespace Chess {
+namespace AI {
+
+// Оценка заведомо выигранного эндшпиля: выше любой обычной, ниже матовых.
+// Сверху добавляется прогресс (материал, король соперника у края), чтобы
+// поиск видел, куда вести реализацию, а не топтался на месте.
+constexpr int SCORE_KNOWN_WIN = 10000;
+
+namespace Endgames {
+
+// Множитель эндшпильной части оценки: SCALE_NORMAL - без изменений, 0 - ничья
+constexpr int SCALE_NORMAL = 64;
+
+// Оценка за сильную сторону strong - вместо общей оценки позиции
+using EvaluateFn = int (*)(const Board& board, Color strong);
+// Множитель для стороны strong, которая впереди по эндшпильной оценке
+using ScaleFn = int (*)(const Board& board, Color strong);
+
+// Ровно одно из evaluate/scale задано
+struct Entry {
+    EvaluateFn evaluate = nullptr;
+    ScaleFn scale = nullptr;
+    Color strong = Color::White;    // Для evaluate: чья это сильная сторона
+};
+
+// Специальная оценка или масштаб для позиции; nullptr - обычная оценка.
+// Выбор за O(1): по материальной сигнатуре доски (Board::materialKey) и паре
+// проверок битовых досок (голый король, сторона без пешек). Порядок: точная
+// сигнатура (KBNK, KPK, KRKP, ...), затем KXK, затем масштаб по сигнатуре
+// без пешек (разноцветные слоны), затем общее правило для стороны без пешек.
+const Entry* probe(const Board& board);
+
+// Сигнатура по коду вида "KBNK": фигуры сильной стороны, затем слабой
+uint64_t materialKeyOf(const char* code, Color strong);
+
+}}} // namespace Chess::AI::Endgames
@@ -2,30 +2,162 @@
 
 #include "core/Board.h"
 #include "core/Move.h"
+#include "ai/EvalCache.h"
+#include "ai/PawnHashTable.h"
+#include "ai/Score.h"
+#include "ai/SpscQueue.h"
+#include "ai/TranspositionTable.h"
+#include <array>
+#include <cstdint>
 #include <functional>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <fstream>
 #include <mutex>
 #include <thread>
 #include <vector>
 #include <future>
+#include <memory>
 #include <unordered_set>
 #include <string>
 
 namespace Chess {
 namespace AI {
 
+namespace Nnue {
+struct Network;
+class Accumulator;
+}
+
+// Статистика поиска (для оценки качества упорядочивания ходов)
+struct SearchStats {
+    uint64_t betaCutoffs = 0;       // Всего beta-отсечений
+    uint64_t firstMoveCutoffs = 0;  // Из них на первом ходе
+    uint64_t nullMoveTries = 0;     // Поисков после нулевого хода
+    uint64_t nullMoveCutoffs = 0;   // Подтвержденных отсечений нулевым ходом
+    uint64_t nullMoveVerifyFails = 0; // Отсечений, отвергнутых проверочным поиском (цугцванг)
+    uint64_t lmrReductions = 0;     // Ходов, просмотренных с сокращенной глубиной (LMR)
+    uint64_t lmrReSearches = 0;     // Из них пересмотренных на полной глубине
+    uint64_t lmpPruned = 0;         // Поздних тихих ходов, отброшенных без поиска (LMP)
+    uint64_t pvsReSearches = 0;     // Пересмотров с полным окном после нулевого (PVS)
+    uint64_t reverseFutilityCutoffs = 0; // Узлов, отсеченных по статической оценке (RFP)
+    uint64_t razorCutoffs = 0;      // Узлов, сведенных к quiescence (razoring)
+    uint64_t futilityPruned = 0;    // Тихих ходов, отброшенных futility pruning
+    uint64_t deltaPruned = 0;       // Взятий, отброшенных delta pruning в quiescence
+    uint64_t ttCutoffs = 0;         // Узлов, закрытых записью таблицы транспозиций
+    uint64_t mateDistanceCutoffs = 0; // Узлов, отсеченных по расстоянию до мата
+    uint64_t bitbaseDraws = 0;      // Узлов KPK, закрытых ничьей по битовой базе
+    uint64_t checkExtensions = 0;   // Продлений на шах
+    uint64_t evalCacheHits = 0;     // Статических оценок, взятых из кеша оценок
+    uint64_t evalCacheMisses = 0;   // Статических оценок, посчитанных заново
+    uint64_t lazyMaterialExits = 0; // Ленивых оценок, законченных после материала и пешек
+    uint64_t lazyKingFilesExits = 0; // ... после короля и линий, без подвижности
+
+    // Доля отсечений на первом ходе (идеальное упорядочивание -> 1.0)
+    double firstMoveCutoffRate() const {
+        return betaCutoffs ? static_cast<double>(firstMoveCutoffs) / betaCutoffs : 0.0;
+    }
+
+    // Доля попаданий в кеш оценок
+    double evalCacheHitRate() const {
+        uint64_t probes = evalCacheHits + evalCacheMisses;
+        return probes ? static_cast<double>(evalCacheHits) / probes : 0.0;
+    }
+
+    void merge(const SearchStats& other) {
+        betaCutoffs += other.betaCutoffs;
+        firstMoveCutoffs += other.firstMoveCutoffs;
+        nullMoveTries += other.nullMoveTries;
+        nullMoveCutoffs += other.nullMoveCutoffs;
+        nullMoveVerifyFails += other.nullMoveVerifyFails;
+        lmrReductions += other.lmrReductions;
+        lmrReSearches += other.lmrReSearches;
+        lmpPruned += other.lmpPruned;
+        pvsReSearches += other.pvsReSearches;
+        reverseFutilityCutoffs += other.reverseFutilityCutoffs;
+        razorCutoffs += other.razorCutoffs;
+        futilityPruned += other.futilityPruned;
+        deltaPruned += other.deltaPruned;
+        ttCutoffs += other.ttCutoffs;
+        mateDistanceCutoffs += other.mateDistanceCutoffs;
+        bitbaseDraws += other.bitbaseDraws;
+        checkExtensions += other.checkExtensions;
+        evalCacheHits += other.evalCacheHits;
+        evalCacheMisses += other.evalCacheMisses;
+        lazyMaterialExits += other.lazyMaterialExits;
+        lazyKingFilesExits += other.lazyKingFilesExits;
+    }
+};
+
+// Настраиваемые параметры селективности поиска
+struct SearchParams {
+    // Late move reductions: R = lmrBase + ln(depth) * ln(moveIndex) / lmrDivisor
+    bool lmrEnabled = true;
+    double lmrBase = 0.75;
+    double lmrDivisor = 2.25;
+    int lmrMinDepth = 3;        // Не сокращаем на меньшей глубине
+    int lmrMinMoveIndex = 3;    // Первые ходы всегда на полной глубине
+
+    // Late move pruning: на глубине <= lmpMaxDepth тихие ходы после
+    // lmpBaseMoves + depth * depth уже просмотренных не ищутся
+    bool lmpEnabled = true;
+    int lmpMaxDepth = 3;
+    int lmpBaseMoves = 3;
+
+    // Отсечения у листьев по статической оценке, запасы по глубине (индекс - depth).
+    // Reverse futility: eval - margin >= beta -> узел не ищем.
+    // Razoring: eval + margin < alpha -> сразу quiescence.
+    // Futility: eval + margin <= alpha -> тихие ходы не ищем.
+    bool futilityEnabled = true;
+    std::array<int, 4> reverseFutilityMargins = {0, 120, 240, 360};
+    std::array<int, 3> razorMargins = {0, 300, 550};
+    std::array<int, 3> futilityMargins = {0, 200, 400};
+
+    // Delta pruning: взятие не ищем, если stand pat + жертва + запас < alpha
+    bool deltaPruningEnabled = true;
+    int deltaMargin = 200;
+
+    // Ленивая оценка в quiescence: подвижность и король не считаются, если
+    // оценка и без них далеко за окном
+    bool lazyEvalEnabled = true;
+};
+
 struct SearchResult {
     Move bestMove;
-    int score;
+    int score;                  // Сантипешки или матовая оценка (см. ai/Score.h)
     int depth;
-    int nodesSearched;
+    int nodesSearched;          // Всего узлов (основной поиск + quiescence)
     double timeSpent;
+    SearchStats stats;
+    std::vector<Move> pv;       // Главный вариант, pv[0] == bestMove
+    int selDepth = 0;           // Максимальная достигнутая глубина с учетом quiescence
+    int mainNodes = 0;          // Узлов основного поиска
+    int quiescenceNodes = 0;    // Узлов quiescence search
+};
+
+// Снимок бесконечного анализа
+struct AnalysisSnapshot {
+    int depth = 0;              // Последняя завершенная итерация
+    int selDepth = 0;
+    int score = 0;
+    std::vector<Move> pv;
+    uint64_t nodes = 0;         // С начала анализа (с точностью до пачки узлов потока)
+    uint64_t nps = 0;
+    int hashfull = 0;           // Заполненность таблицы транспозиций, промилле
+    int elapsedMs = 0;
+    bool finished = false;      // Последний снимок: анализ остановлен
 };
 
 class Engine {
 public:
     explicit Engine(Board& board);
+    ~Engine();
+
+    // Движок с общей таблицей транспозиций (потоки поиска, анализ) и,
+    // если задан, общим кешем оценок
+    Engine(Board& board, std::shared_ptr<TranspositionTable> table,
+           std::shared_ptr<EvalCache> evalCache = nullptr);
 
     // Найти лучший ход
     SearchResult findBestMove(Color color, int maxDepth = 5);
@@ -33,6 +165,44 @@ public:
     // Найти лучший ход с ограничением по времени (миллисекунды)
     SearchResult findBestMoveWithTimeLimit(Color color, int timeMs);
 
+    // Найти лучший ход с ограничением по числу узлов. В детерминированном
+    // режиме повторяется от запуска к запуску, в отличие от лимита по времени.
+    SearchResult findBestMoveWithNodeLimit(Color color, uint64_t maxNodes);
+
+    // Пондеринг: поиск в фоновом потоке на время соперника. Доска движка должна
+    // стоять в позиции после ожидаемого ответа соперника. Поиск идет без лимита
+    // времени до ponderHit() (дальше - лимит timeMs от начала пондеринга) или stop().
+    std::future<SearchResult> startPondering(Color color, int timeMs);
+    void ponderHit();
+
+    // MultiPV: numLines лучших вариантов, от лучшего к худшему. Каждая линия -
+    // поиск с полным окном среди ходов, не вошедших в предыдущие линии; таблица
+    // транспозиций общая, поэтому линии после первой обходятся намного дешевле.
+    std::vector<SearchResult> findBestMoves(Color color, int numLines, int maxDepth = 5);
+
+    // Бесконечный анализ в фоновом потоке до stopAnalysis(). Отдельный поток
+    // раз в intervalMs публикует AnalysisSnapshot в lock-free канал; читатель
+    // забирает снимки через pollAnalysis(), не блокируя потоки поиска.
+    // Читать канал должен один поток - тот же, что вызывает start/stopAnalysis.
+    void startAnalysis(Color color, int intervalMs = 500);
+    void stopAnalysis();
+    bool isAnalyzing() const { return analysisThread_.joinable(); }
+    bool pollAnalysis(AnalysisSnapshot& snapshot);
+
+    // Для других алгоритмов поиска (MCTS): оценка позиции quiescence-поиском с
+    // полным окном с точки зрения color и легальные ходы в порядке перебора
+    int quiescenceScore(Color color);
+    std::vector<Move> orderedMoves(Color color);
+
+    // Детерминированный режим для бенчмарков: один поток, перед каждым поиском
+    // очищаются таблица транспозиций, эвристики и главный вариант прошлого поиска
+    void setDeterministic(bool deterministic) { deterministic_ = deterministic; }
+    bool isDeterministic() const { return deterministic_; }
+
+    // Многопоточный поиск в корне (по умолчанию включен). Выключается, когда
+    // параллельно работают сразу много движков - например, в матче.
+    void setParallelRoot(bool enabled) { parallelRoot_ = enabled; }
+
     // Установить сложность (глубина поиска)
     void setDifficulty(int depth) { maxDepth_ = depth; }
     int getDifficulty() const { return maxDepth_; }
@@ -41,6 +211,24 @@ public:
     using ProgressCallback = std::function<void(int depth, int score, const Move& move)>;
     void setProgressCallback(ProgressCallback callback) { progressCallback_ = callback; }
 
+    // Параметры селективности (LMR/LMP)
+    void setSearchParams(const SearchParams& params);
+    const SearchParams& getSearchParams() const { return params_; }
+
+    // Таблица транспозиций
+    void setHashSize(size_t sizeMb);
+    void clearHash();
+    std::shared_ptr<TranspositionTable> transpositionTable() const { return tt_; }
+
+    // Нейросетевая оценка вместо классической (nullptr - классическая).
+    // Сеть общая для потоков, аккумулятор - свой у каждого движка.
+    void setNnue(std::shared_ptr<const Nnue::Network> network);
+    bool usesNnue() const { return nnue_ != nullptr; }
+
+    // Кеш статических оценок (попадания - в SearchStats)
+    void setEvalCacheSize(size_t sizeMb);
+    std::shared_ptr<EvalCache> evalCache() const { return evalCache_; }
+
     // Остановить поиск
     void stop() { shouldStop_ = true; }
 
@@ -54,18 +242,135 @@ private:
     ProgressCallback progressCallback_;
     std::string logFilename_;
     std::mutex logMutex_;
+    SearchParams params_;
+    std::shared_ptr<TranspositionTable> tt_;
+
+    std::shared_ptr<EvalCache> evalCache_;
+    std::shared_ptr<const Nnue::Network> nnue_;
+    std::unique_ptr<Nnue::Accumulator> accumulator_;
+
+    // Кеш пешечной структуры: свой у каждого движка, то есть у каждого потока
+    PawnHashTable pawnTable_;
+
+    // Управление временем. Потоки корневого поиска смотрят на флаг остановки
+    // и дедлайн родительского движка.
+    static constexpr int TIME_CHECK_INTERVAL = 1024;
+    Engine* parent_ = nullptr;
+    std::atomic<int64_t> deadlineNs_{0};    // steady_clock, 0 - без лимита
+    std::atomic<uint64_t> nodeLimit_{0};    // 0 - без лимита
+    bool deterministic_ = false;
+    bool parallelRoot_ = true;
+    std::chrono::steady_clock::time_point searchStart_;
+    int ponderTimeMs_ = 0;
+    int timeCheckCounter_ = 0;
+
+    void prepareSearch();    // Сброс флагов и лимитов в начале каждого поиска
+    void setDeadline(std::chrono::steady_clock::time_point deadline);
+    bool stopRequested() const;
+    void pollDeadline();
+    void flushNodeCount();  // Узлы с последнего опроса - в liveNodes_ корневого движка
+
+    // Бесконечный анализ: поток поиска отдает завершенные итерации в
+    // analysisResult_, поток-репортер - единственный писатель канала
+    using AnalysisChannel = SpscQueue<AnalysisSnapshot, 64>;
+    std::unique_ptr<AnalysisChannel> analysisChannel_;
+    std::thread analysisThread_;
+    std::thread reporterThread_;
+    std::atomic<bool> analysisActive_{false};
+    std::atomic<uint64_t> liveNodes_{0};
+    std::mutex analysisMutex_;
+    std::condition_variable analysisCv_;
+    bool analysisDone_ = false;                 // Под analysisMutex_
+    SearchResult analysisResult_;               // Под analysisMutex_
+
+    void publishSnapshot(bool finished);
+
+    // Таблица сокращений LMR [глубина][номер хода], пересчитывается из params_
+    static constexpr int LMR_TABLE_SIZE = 64;
+    int lmrTable_[LMR_TABLE_SIZE][LMR_TABLE_SIZE];
+    void initLmrTable();
+    int lmrReduction(int depth, int moveIndex) const;
+
+    // Эвристики упорядочивания тихих ходов. В многопоточном поиске у каждого
+    // потока свой Engine, поэтому таблицы у потоков независимые.
+    static constexpr int MAX_PLY = 64;
+    static constexpr int MAX_HISTORY = 16384;
 
-    // Minimax с alpha-beta отсечением
-    int alphaBeta(int depth, int alpha, int beta, Color color, int& nodesSearched);
+    Move killerMoves_[MAX_PLY][2];                    // Киллеры по ply
+    int history_[2][NUM_SQUARES][NUM_SQUARES];        // History [цвет][откуда][куда]
+    Move counterMoves_[NUM_SQUARES][NUM_SQUARES];     // Ответ на ход [откуда][куда]
+    Move moveStack_[MAX_PLY];                         // Ход на каждом ply (Move() - нулевой ход)
+    SearchStats stats_;
+
+    // Треугольная таблица главного варианта: pvTable_[ply] - лучшая линия
+    // из узла на ply, ходы с индексами [ply, pvLength_[ply])
+    Move pvTable_[MAX_PLY + 1][MAX_PLY + 1];
+    int pvLength_[MAX_PLY + 1];
+    int quiescenceNodes_ = 0;
+    int selDepth_ = 0;
+
+    // Главный вариант прошлой итерации (для упорядочивания в корне)
+    std::vector<Move> lastPv_;
+    uint64_t lastPvHash_ = 0;
+
+    std::vector<Move> extractPv(int ply) const;
+    void updatePv(int ply, const Move& move);
+
+    // Результат поиска одного хода из корня в отдельном потоке
+    struct RootMoveResult {
+        Move move;
+        int score;
+        bool exact;             // false - оценка из нулевого окна (верхняя граница)
+        std::vector<Move> pv;
+        int cpu;                // CPU, за которым закреплен поток (-1 - не закреплен)
+    };
+
+    // Движок потока корневого поиска: живет между ходами и итерациями, так что
+    // пешечный кеш и аккумулятор не создаются заново на каждый ход из корня.
+    // Слот i всегда считает i-й ход корня и закреплен за тем же CPU.
+    struct RootWorker {
+        Board board;
+        std::unique_ptr<Engine> engine;
+    };
+    std::vector<std::unique_ptr<RootWorker>> rootWorkers_;
+
+    // Итеративное углубление до depthLimit или до остановки
+    SearchResult iterativeDeepening(Color color, int depthLimit);
+
+    // Поиск из корня на фиксированную глубину (одна итерация)
+    SearchResult searchRoot(Color color, int maxDepth, const std::vector<Move>& excludedMoves = {});
+
+    // Minimax с alpha-beta отсечением (ply - расстояние от корня,
+    // allowNull = false запрещает нулевой ход в этом узле)
+    int alphaBeta(int depth, int alpha, int beta, Color color, int& nodesSearched, int ply,
+                  bool allowNull = true);
+
+    // Null-move pruning: true, если пропуск хода все равно дает score >= beta
+    bool tryNullMovePruning(int depth, int beta, Color color, bool inCheck, int staticEval,
+                            int& nodesSearched, int ply, int& score);
+
+    // Статическая оценка с точки зрения стороны color
+    int evaluateForSide(Color color);
+    // То же с окном (alpha, beta) за color: вне окна может вернуть границу (ленивая оценка)
+    int evaluateForSide(Color color, int alpha, int beta);
 
     // Quiescence search для стабильной оценки
-    int quiescence(int alpha, int beta, Color color, int& nodesSearched, int depth = 0);
+    int quiescence(int alpha, int beta, Color color, int& nodesSearched, int ply, int depth = 0);
 
     // Упорядочивание ходов для лучшего отсечения
-    void orderMoves(std::vector<Move>& moves, Color color) const;
+    void orderMoves(std::vector<Move>& moves, Color color, int ply = -1,
+                    const Move& ttMove = Move()) const;
+
+    // Оценка хода для упорядочивания (ply < 0 - без эвристик тихих ходов)
+    int scoreMoveForOrdering(const Move& move, Color color, int ply = -1) const;
 
-    // Оценка хода для упорядочивания
-    int scoreMoveForOrdering(const Move& move, Color color) const;
+    // Обновление killer/history/countermove после beta-отсечения тихим ходом
+    void updateQuietHeuristics(const Move& move, Color color, int depth, int ply,
+                               const std::vector<Move>& quietsSearched);
+    void updateHistory(Color color, const Move& move, int bonus);
+    void resetHeuristics();
+    void ageHistory();
+    static bool isQuiet(const Move& move) { return !move.isCapture() && !move.isPromotion(); }
     
     // Логирование
     void log(const std::string& message);
@@ -73,10 +378,8 @@ private:
     void logMoveEvaluation(const Move& move, int score, int depth, int nodes);
     void logSearchResult(const SearchResult& result);
     
-    // Обнаружение повторений и оценка эндшпиля
-    int checkPositionRepetition(const std::string& fen) const;
-    int evaluateEndgameMate(const Board& board, Color color) const;
-    bool isKingOnlyEndgame(const Board& board, Color color) const;
+    // Обнаружение повторений
+    int checkPositionRepetition() const;
 };
 
 }} // namespace Chess::AI
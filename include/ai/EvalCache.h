@@ -0,0 +1,50 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace Chess {
+namespace AI {
+
+// Кеш статической оценки по Zobrist-хешу позиции, общий для потоков поиска.
+// Слот - одно 64-битное слово: старшие 48 бит ключа и 16-битная оценка.
+// Слово читается и пишется атомарно, поэтому "разорванных" записей не бывает;
+// младшие биты ключа проверяет сам индекс слота.
+class EvalCache {
+public:
+    explicit EvalCache(size_t sizeMb = DEFAULT_SIZE_MB);
+
+    // Изменить размер (содержимое теряется)
+    void resize(size_t sizeMb);
+    void clear();
+
+    bool probe(uint64_t key, int& score) const {
+        uint64_t data = slots_[key & mask_].load(std::memory_order_relaxed);
+        if (data == 0 || ((data ^ key) & KEY_MASK) != 0) {
+            return false;
+        }
+        score = static_cast<int16_t>(data & SCORE_MASK);
+        return true;
+    }
+
+    void store(uint64_t key, int score) {
+        uint64_t data = (key & KEY_MASK) | (static_cast<uint16_t>(score) & SCORE_MASK);
+        slots_[key & mask_].store(data, std::memory_order_relaxed);
+    }
+
+    size_t sizeMb() const { return sizeMb_; }
+
+    static constexpr size_t DEFAULT_SIZE_MB = 1;
+
+private:
+    static constexpr uint64_t SCORE_MASK = 0xFFFF;
+    static constexpr uint64_t KEY_MASK = ~SCORE_MASK;
+
+    std::unique_ptr<std::atomic<uint64_t>[]> slots_;
+    size_t mask_ = 0;
+    size_t sizeMb_ = 0;
+};
+
+}} // namespace Chess::AI
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "core/Types.h"
+#include <array>
+#include <cstdint>
+
+namespace Chess {
+namespace AI {
+
+// Вес или сумма весов: отдельно для миттельшпиля и эндшпиля. Итог оценки -
+// их смесь по фазе игры (Board::gamePhase).
+struct PhaseScore {
+    int mg = 0;
+    int eg = 0;
+};
+
+// Все параметры классической оценки. Оценка линейна по ним, поэтому структура
+// заодно - вектор параметров для тюнера (chess-tune): поля идут подряд без
+// промежутков, номер параметра - indexOf. Штрафы хранятся отрицательными.
+struct EvalParams {
+    // Материал и Piece-Square Tables по типу фигуры (индекс - PieceType - 1).
+    // Таблицы записаны со стороны белых: первая строка - 8-я горизонталь.
+    PhaseScore material[6];
+    PhaseScore psqt[6][NUM_SQUARES];
+
+    // Пешечная структура; бонус проходной - по горизонтали со стороны владельца
+    PhaseScore doubledPawn;
+    PhaseScore isolatedPawn;
+    PhaseScore passedPawn[8];
+
+    // Безопасность короля: пешечный щит и вертикаль без своих пешек рядом
+    PhaseScore pawnShield;
+    PhaseScore kingSemiOpenFile;
+
+    // Ладья на открытой (без пешек) и полуоткрытой (без своих пешек) вертикали,
+    // конь на форпосте
+    PhaseScore rookOpenFile;
+    PhaseScore rookSemiOpenFile;
+    PhaseScore knightOutpost;
+
+    // Вес клетки подвижности: конь, слон, ладья, ферзь
+    PhaseScore mobility[4];
+
+    static constexpr int SIZE = 6 + 6 * NUM_SQUARES + 2 + 8 + 2 + 3 + 4;
+
+    PhaseScore* data() { return &material[0]; }
+    const PhaseScore* data() const { return &material[0]; }
+    int indexOf(const PhaseScore& weight) const { return static_cast<int>(&weight - data()); }
+};
+
+static_assert(sizeof(EvalParams) == EvalParams::SIZE * sizeof(PhaseScore),
+              "EvalParams должен быть плотным массивом PhaseScore");
+
+// Параметры, с которыми играет движок
+extern const EvalParams DEFAULT_EVAL_PARAMS;
+
+// Разложение оценки по параметрам: оценка = сумма coeffs[i] * вес i, смешанная
+// по фазе. Коэффициент - число срабатываний за белых минус за черных.
+struct EvalTrace {
+    std::array<int16_t, EvalParams::SIZE> coeffs{};
+};
+
+}} // namespace Chess::AI
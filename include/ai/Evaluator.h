@@ -2,41 +2,80 @@
 
 #include "core/Board.h"
 #include "core/Types.h"
+#include "ai/EvalParams.h"
+#include "ai/PawnHashTable.h"
 
 namespace Chess {
 namespace AI {
 
+// Этап, на котором закончилась оценка с окном
+enum class LazyExit : uint8_t {
+    Material,       // После материала, PSQT и пешек
+    KingAndFiles,   // После безопасности короля и линий - без подвижности
+    Full            // Оценка посчитана целиком
+};
+
+// Ядро материала и PSQT: по фигурам (эталон; он же - при разложении для тюнера),
+// по таблице кодов фигур скалярно или AVX2 - gather по той же таблице
+enum class PieceKernel { Reference, Scalar, Avx2 };
+
 class Evaluator {
 public:
-    explicit Evaluator(const Board& board);
+    // pawnTable - кеш пешечной структуры потока; без него структура считается каждый раз
+    explicit Evaluator(const Board& board, PawnHashTable* pawnTable = nullptr);
 
     // Оценка позиции с точки зрения белых (положительная = белые лучше)
     int evaluate() const;
 
+    // Ленивая оценка с окном (alpha, beta) за белых: дешевые слагаемые считаются
+    // первыми, и если частичная оценка с запасом на оставшиеся (верхняя граница их
+    // вклада по параметрам оценки) уже не попадает в окно, возвращается частичная
+    // оценка - она по ту же сторону окна, что и точная.
+    // Такой результат годится для отсечений, но не для кеша оценок.
+    int evaluate(int alpha, int beta, LazyExit* exit = nullptr) const;
+
+    // Раскладывать оценку по параметрам (для тюнера); nullptr - не раскладывать
+    void setTrace(EvalTrace* trace) { trace_ = trace; }
+
+    // Ядро материала и PSQT. По умолчанию - лучшее, что поддерживает CPU;
+    // все ядра дают одну и ту же оценку. Переключать только вне поиска.
+    static PieceKernel detectedPieceKernel();
+    static PieceKernel pieceKernel();
+    static void setPieceKernel(PieceKernel kernel);
+    static const char* pieceKernelName(PieceKernel kernel);
+
 private:
     const Board& board_;
+    PawnHashTable* pawnTable_;
+    EvalTrace* trace_ = nullptr;
+    static const EvalParams& params_;
+
+    // Учесть параметр count раз (со знаком стороны)
+    void add(PhaseScore& score, const PhaseScore& weight, int count) const {
+        score.mg += weight.mg * count;
+        score.eg += weight.eg * count;
+        if (trace_) {
+            trace_->coeffs[params_.indexOf(weight)] += static_cast<int16_t>(count);
+        }
+    }
 
     // Компоненты оценки
-    int evaluateMaterial() const;
-    int evaluatePosition() const;
-    int evaluateMobility() const;
-    int evaluateKingSafety() const;
-    int evaluatePawnStructure() const;
-
-    // Piece-Square Tables для позиционной оценки
-    static const int PAWN_TABLE[64];
-    static const int KNIGHT_TABLE[64];
-    static const int BISHOP_TABLE[64];
-    static const int ROOK_TABLE[64];
-    static const int QUEEN_TABLE[64];
-    static const int KING_MIDDLE_GAME_TABLE[64];
-    static const int KING_END_GAME_TABLE[64];
-
-    // Оценка для конкретной клетки
-    int getPieceSquareValue(const Piece& piece, Square sq) const;
-
-    // Определить, эндшпиль ли
-    bool isEndgame() const;
+    void evaluatePieces(PhaseScore& score) const;      // Материал + Piece-Square Tables
+    void evaluatePiecesReference(PhaseScore& score) const;
+    void evaluateMobility(const PawnEntry& pawns, PhaseScore& score) const;
+    void evaluateMobility(const PawnEntry& pawns, Color color, PhaseScore& score) const;
+    void evaluateKingSafety(const PawnEntry& pawns, PhaseScore& score) const;
+    void evaluatePieceFiles(const PawnEntry& pawns, PhaseScore& score) const; // Ладьи на открытых линиях, форпосты
+
+    // Смесь по фазе игры
+    int blend(const PhaseScore& score) const {
+        int phase = board_.gamePhase();
+        return (score.mg * phase + score.eg * (Board::PHASE_MAX - phase)) / Board::PHASE_MAX;
+    }
+
+    // Пешечная структура: из таблицы или вычисляется (и кладется в таблицу)
+    const PawnEntry& probePawns(PawnEntry& local) const;
+    void evaluatePawnStructure(PawnEntry& entry) const;
 };
 
 }} // namespace Chess::AI
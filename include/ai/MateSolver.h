@@ -0,0 +1,74 @@
+#pragma once
+
+#include "core/Board.h"
+#include "core/Move.h"
+#include "ai/TranspositionTable.h"
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Chess {
+namespace AI {
+
+// Результат решения задачи "мат в N"
+struct MateSolverResult {
+    bool found = false;
+    int mateIn = 0;                 // Ходов атакующей стороны
+    std::vector<Move> line;         // Матующий вариант при самой упорной защите
+    // Доказательство единственности: все легальные первые ходы атакующего
+    // проверены на глубине mateIn полным перебором (и в режиме одних шахов),
+    // alternatives - другие ходы, тоже матующие не позже mateIn. При остановке
+    // до конца проверки unique = false.
+    bool unique = false;
+    std::vector<Move> alternatives;
+    uint64_t nodes = 0;
+    double timeSpent = 0.0;
+};
+
+// Решатель "мат в N". В отличие от Engine здесь нет оценки и quiescence:
+// атакующий перебирает только шахи, защищающийся - все ответы (при шахе это
+// уходы от шаха). Результаты позиций хранятся в таблице транспозиций.
+// Сторона, которая ходит в переданной позиции, - атакующая.
+class MateSolver {
+public:
+    explicit MateSolver(size_t hashMb = 16);
+
+    // Найти кратчайший мат не длиннее maxMoves ходов (итерации по N = 1..maxMoves)
+    MateSolverResult solve(const Board& board, int maxMoves);
+
+    // Число потоков: ходы корня делятся между потоками, таблица общая
+    void setThreads(int threads) { threads_ = threads > 0 ? threads : 1; }
+
+    // Только шахи у атакующего (по умолчанию). Без этого режима решаются и
+    // задачи с тихими ходами, но перебор намного шире. Проверка единственности
+    // найденного мата идет полным перебором в любом режиме.
+    void setChecksOnly(bool checksOnly) { checksOnly_ = checksOnly; }
+
+    void stop() { shouldStop_ = true; }
+
+private:
+    TranspositionTable tt_;
+    int threads_ = 1;
+    bool checksOnly_ = true;
+    std::atomic<bool> shouldStop_{false};
+    std::atomic<uint64_t> nodes_{0};
+
+    // Атакующий на ходу: есть ли мат не более чем за movesLeft ходов
+    bool attack(Board& board, Color attacker, int movesLeft, uint64_t& nodes);
+    // Защищающийся на ходу: получает ли он мат при любой защите за movesLeft ходов атакующего
+    bool defend(Board& board, Color attacker, int movesLeft, uint64_t& nodes);
+
+    // Ходы корня из позиции fen, проверенные на мат за n ходов всеми потоками
+    std::vector<char> rootWins(const std::string& fen, const std::vector<Move>& moves, Color attacker, int n);
+
+    // Ходы атакующего в порядке перебора (взятия и превращения первыми)
+    std::vector<Move> attackerMoves(Board& board, Color attacker) const;
+
+    // Кратчайший мат из позиции атакующего (0 - нет за maxMoves)
+    int mateDistance(Board& board, Color attacker, int maxMoves, uint64_t& nodes);
+    // Главный вариант: кратчайший мат против самой упорной защиты
+    void buildLine(Board& board, Color attacker, int mateIn, std::vector<Move>& line, uint64_t& nodes);
+};
+
+}} // namespace Chess::AI
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "core/Board.h"
+#include "core/Move.h"
+#include "ai/Engine.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Chess {
+namespace AI {
+
+// Параметры MCTS
+struct MctsParams {
+    float cpuct = 1.5f;             // Вес исследования в формуле PUCT
+    float fpuReduction = 0.2f;      // Оценка непосещенного хода: Q родителя минус это значение
+    int virtualLoss = 3;            // Виртуальные поражения узла, через который идет другой поток
+    int threads = 4;
+    size_t poolSizeMb = 64;         // Пул узлов дерева
+    bool reuseTree = true;          // Переиспользовать поддерево между ходами
+};
+
+// Альтернативный поиск: Monte Carlo Tree Search с формулой PUCT.
+// Значение листа - quiescence-оценка Engine, априорные вероятности ходов -
+// по их месту в упорядочивании alpha-beta. Результат - тот же SearchResult,
+// что у Engine, чтобы сравнивать алгоритмы напрямую.
+class MctsEngine {
+public:
+    explicit MctsEngine(Board& board);
+
+    // Лучший ход по числу симуляций / по времени (миллисекунды). Ищет за сторону
+    // на ходу в позиции доски; color - для совместимости с интерфейсом Engine.
+    SearchResult findBestMove(Color color, int simulations);
+    SearchResult findBestMoveWithTimeLimit(Color color, int timeMs);
+
+    void setParams(const MctsParams& params);
+    const MctsParams& getParams() const { return params_; }
+
+    // Сбросить дерево (новая партия)
+    void clearTree();
+
+    void stop() { shouldStop_ = true; }
+
+private:
+    // Узел дерева. Дети узла лежат в пуле подряд: [firstChild, firstChild + childCount).
+    // Значение хранится с точки зрения стороны, сделавшей ход в этот узел.
+    struct Node {
+        Move move;
+        float prior = 0.0f;
+        std::atomic<int32_t> visits{0};
+        std::atomic<int32_t> virtualLoss{0};
+        std::atomic<int64_t> valueSum{0};       // В единицах VALUE_SCALE
+        uint32_t firstChild = 0;
+        uint16_t childCount = 0;
+        int8_t terminalValue = 0;               // Для стороны на ходу: -1 мат, 0 ничья
+        std::atomic<uint8_t> state{0};          // NodeState
+    };
+
+    enum NodeState : uint8_t { Unexpanded = 0, Expanding, Expanded, Terminal };
+    static constexpr int64_t VALUE_SCALE = 1 << 16;
+
+    Board& board_;
+    MctsParams params_;
+    std::atomic<bool> shouldStop_{false};
+
+    // Пул узлов: выделение - сдвиг атомарного счетчика, освобождение - сброс всего пула
+    std::unique_ptr<Node[]> pool_;
+    uint32_t poolCapacity_ = 0;
+    std::atomic<uint32_t> poolUsed_{0};
+    uint32_t root_ = 0;
+    std::string rootFen_;               // Позиция корня - для переиспользования дерева
+
+    std::atomic<int> maxPathLength_{0};
+
+    void allocatePool();
+    void resetTree();
+    uint32_t allocateNodes(uint32_t count);     // 0 - пул исчерпан
+
+    // Найти позицию доски среди потомков старого корня (до двух полуходов)
+    bool reuseTree();
+
+    SearchResult search(int simulations, int timeMs);
+    void runSimulation(Board& board, Engine& evaluator);
+    uint32_t selectChild(const Node& node) const;
+    float expand(Node& node, Board& board, Engine& evaluator);
+    float evaluateLeaf(Board& board, Engine& evaluator) const;
+
+    std::vector<Move> principalVariation() const;
+    static float nodeQ(const Node& node);
+};
+
+}} // namespace Chess::AI
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "core/Board.h"
+#include "core/BoardObserver.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Chess {
+namespace AI {
+namespace Nnue {
+
+// Эффективно обновляемая нейросетевая оценка (NNUE).
+//
+// Входы HalfKP: для каждой стороны-"перспективы" - (клетка своего короля,
+// фигура, клетка фигуры) для всех фигур, кроме королей: 64 * 10 * 64.
+// Первый слой - int16-аккумулятор на перспективу, обновляется при каждом
+// ходе по изменившимся фигурам. Дальше - два int8-слоя с clipped ReLU и выход.
+//
+//   2 x [FEATURES -> L1] -> [2*L1 -> L2] -> [L2 -> L3] -> [L3 -> 1]
+
+constexpr int FEATURES = 64 * 10 * 64;
+constexpr int L1 = 128;
+constexpr int L2 = 32;
+constexpr int L3 = 32;
+
+constexpr int WEIGHT_SHIFT = 6;         // Масштаб int8-весов скрытых слоев: 1.0 = 64
+constexpr int ACTIVATION_MAX = 127;     // Clipped ReLU: [0, 127]
+constexpr int OUTPUT_SCALE = 16;        // Выход сети / OUTPUT_SCALE = сантипешки
+
+// Набор инструкций для ядер сети. Выбирается при запуске по возможностям CPU.
+enum class SimdLevel { Scalar, Sse41, Avx2 };
+
+SimdLevel detectedSimdLevel();          // Лучший, что поддерживает CPU
+SimdLevel simdLevel();                  // Текущий
+// Принудительно понизить (замеры, проверка совпадения ядер). Не выше
+// detectedSimdLevel; вызывать только вне поиска.
+void setSimdLevel(SimdLevel level);
+const char* simdLevelName(SimdLevel level);
+
+// Веса сети (только чтение, общие для всех потоков)
+struct Network {
+    std::vector<int16_t> featureWeights;    // [FEATURES][L1]
+    std::vector<int16_t> featureBias;       // [L1]
+    std::vector<int8_t> hidden1Weights;     // [L2][2 * L1]
+    std::vector<int32_t> hidden1Bias;       // [L2]
+    std::vector<int8_t> hidden2Weights;     // [L3][L2]
+    std::vector<int32_t> hidden2Bias;       // [L3]
+    std::vector<int8_t> outputWeights;      // [L3]
+    int32_t outputBias = 0;
+
+    // Формат файла: "CHNN", версия, размеры слоев (uint32), затем массивы
+    // в порядке полей, little-endian. false и error при ошибке.
+    bool load(const std::string& path, std::string& error);
+    bool save(const std::string& path, std::string& error) const;
+
+    // Случайные веса - для проверки ядер и замеров скорости, не для игры
+    static std::shared_ptr<Network> makeRandom(uint32_t seed);
+};
+
+// Аккумулятор первого слоя, привязанный к доске. Board сообщает о ходах
+// (BoardObserver): на ход - копия состояния и правки по изменившимся
+// фигурам, на отмену - возврат сохраненного состояния без пересчета.
+// Ход своего короля меняет все входы перспективы - она пересчитывается
+// целиком при следующей оценке.
+class Accumulator : public BoardObserver {
+public:
+    explicit Accumulator(std::shared_ptr<const Network> network);
+    ~Accumulator() override;
+
+    Accumulator(const Accumulator&) = delete;
+    Accumulator& operator=(const Accumulator&) = delete;
+
+    void attach(Board& board);
+    void detach();
+
+    // Оценка в сантипешках за сторону на ходу
+    int evaluate(Color sideToMove);
+
+    // Оценка с нуля, без аккумулятора (проверка инкрементальных обновлений)
+    static int evaluateFull(const Network& network, const Board& board);
+
+    void onMakeMove() override;
+    void onPieceChanged(Square sq, const Piece& removed, const Piece& added) override;
+    void onUnmakeMove() override;
+    void onReset(const Board& board) override;
+
+private:
+    struct State {
+        alignas(32) int16_t values[2][L1];
+        bool dirty[2];
+    };
+
+    std::shared_ptr<const Network> network_;
+    Board* board_ = nullptr;
+    std::vector<State> stack_;
+
+    static void refresh(const Network& network, const Board& board, State& state, Color perspective);
+    static int output(const Network& network, const int16_t* us, const int16_t* them);
+};
+
+}}} // namespace Chess::AI::Nnue
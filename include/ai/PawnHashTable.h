@@ -0,0 +1,46 @@
+#pragma once
+
+#include "core/Types.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Chess {
+namespace AI {
+
+// Пешечная структура и производные от нее данные. Зависят только от пешек,
+// поэтому кешируются по Board::pawnKey.
+struct PawnEntry {
+    // Пустой слот. Не 0: ключ позиции без пешек равен нулю
+    static constexpr uint64_t EMPTY_KEY = ~uint64_t(0);
+
+    uint64_t key = EMPTY_KEY;
+    int16_t mg = 0;             // Оценка структуры за белых
+    int16_t eg = 0;
+    Bitboard passed[2] = {};    // Проходные пешки [цвет]
+    Bitboard attacks[2] = {};   // Клетки, которые бьют пешки
+    Bitboard attackSpan[2] = {}; // Клетки, которые пешки могут побить, продвигаясь
+    uint8_t semiOpenFiles[2] = {}; // Вертикали без своих пешек (бит i - вертикаль i)
+};
+
+// Таблица пешечной структуры. Своя у каждого Engine, то есть у каждого потока
+// поиска, - без синхронизации. Запись проверяется полным ключом, поэтому
+// содержимое таблицы не влияет на оценку (важно для детерминированного режима).
+class PawnHashTable {
+public:
+    explicit PawnHashTable(size_t entries = DEFAULT_ENTRIES) : entries_(entries), mask_(entries - 1) {}
+
+    // Слот для ключа: если slot.key == key - данные готовы, иначе их нужно вычислить
+    PawnEntry& slot(uint64_t key) { return entries_[key & mask_]; }
+
+    void clear() { std::fill(entries_.begin(), entries_.end(), PawnEntry()); }
+
+    static constexpr size_t DEFAULT_ENTRIES = 1 << 13;     // Степень двойки
+
+private:
+    std::vector<PawnEntry> entries_;
+    size_t mask_;
+};
+
+}} // namespace Chess::AI
@@ -0,0 +1,48 @@
+#pragma once
+
+namespace Chess {
+namespace AI {
+
+// Шкала оценок поиска. Все оценки лежат в (-SCORE_INFINITY, SCORE_INFINITY),
+// поэтому их можно безопасно менять знак и хранить в 16 битах.
+constexpr int SCORE_INFINITY = 32000;
+
+// Мат на расстоянии ply полуходов от корня оценивается как SCORE_MATE - ply:
+// короткий мат лучше длинного
+constexpr int SCORE_MATE = 31000;
+
+// Максимальная длина варианта, в которую укладываются матовые оценки
+constexpr int MAX_MATE_PLY = 256;
+
+// |score| >= SCORE_MATE_BOUND - это мат
+constexpr int SCORE_MATE_BOUND = SCORE_MATE - MAX_MATE_PLY;
+
+inline constexpr int mateIn(int ply) { return SCORE_MATE - ply; }
+inline constexpr int matedIn(int ply) { return -SCORE_MATE + ply; }
+
+inline constexpr bool isMateScore(int score) {
+    return score >= SCORE_MATE_BOUND || score <= -SCORE_MATE_BOUND;
+}
+
+// Число ходов до мата: > 0 - мы ставим мат, < 0 - нам ставят мат, 0 - не мат
+inline constexpr int mateInMoves(int score) {
+    return score >= SCORE_MATE_BOUND ? (SCORE_MATE - score + 1) / 2
+         : score <= -SCORE_MATE_BOUND ? -(SCORE_MATE + score + 1) / 2
+         : 0;
+}
+
+// В таблице транспозиций матовая оценка хранится относительно узла,
+// а не корня: одна и та же позиция встречается на разных ply
+inline constexpr int scoreToTT(int score, int ply) {
+    return score >= SCORE_MATE_BOUND ? score + ply
+         : score <= -SCORE_MATE_BOUND ? score - ply
+         : score;
+}
+
+inline constexpr int scoreFromTT(int score, int ply) {
+    return score >= SCORE_MATE_BOUND ? score - ply
+         : score <= -SCORE_MATE_BOUND ? score + ply
+         : score;
+}
+
+}} // namespace Chess::AI
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+namespace Chess {
+namespace AI {
+
+// Lock-free очередь "один писатель - один читатель" на кольцевом буфере.
+// Писатель никогда не ждет читателя: если очередь полна, tryPush возвращает false
+// и элемент отбрасывается. Capacity должна быть степенью двойки.
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "Capacity должна быть степенью двойки");
+
+public:
+    // Только поток-писатель
+    bool tryPush(T value) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) == Capacity) {
+            return false;
+        }
+        slots_[tail & (Capacity - 1)] = std::move(value);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Только поток-читатель
+    bool tryPop(T& value) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = std::move(slots_[head & (Capacity - 1)]);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Приблизительно (индексы читаются не атомарно вместе)
+    bool empty() const {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+private:
+    std::array<T, Capacity> slots_{};
+    // Индексы на разных кэш-линиях, чтобы писатель и читатель не мешали друг другу
+    alignas(64) std::atomic<size_t> head_{0};
+    alignas(64) std::atomic<size_t> tail_{0};
+};
+
+}} // namespace Chess::AI
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace Chess {
+namespace AI {
+
+// Политика закрепления рабочих потоков поиска за процессорами
+enum class AffinityPolicy {
+    None,       // Потоками управляет ОС
+    Compact,    // Подряд: сначала заполняется первый NUMA-узел
+    Scatter     // По кругу между NUMA-узлами
+};
+
+// Топология: доступные процессу CPU, сгруппированные по NUMA-узлам
+struct CpuTopology {
+    std::vector<std::vector<int>> nodes;
+
+    int cpuCount() const;
+    int nodeOfCpu(int cpu) const;   // -1, если CPU неизвестен
+};
+
+// Читается один раз (Linux: /sys/devices/system/node и sched_getaffinity;
+// на других системах - один узел)
+const CpuTopology& cpuTopology();
+
+// Глобальная политика для всех движков процесса
+void setAffinityPolicy(AffinityPolicy policy);
+AffinityPolicy affinityPolicy();
+const char* affinityPolicyName(AffinityPolicy policy);
+
+// Закрепить текущий поток по глобальной политике. threadIndex - номер рабочего
+// потока. Возвращает CPU или -1, если поток не закреплен.
+int pinCurrentThread(int threadIndex);
+
+// Закрепить текущий поток за index-м CPU узла node (независимо от политики)
+int pinCurrentThreadToNode(int node, int index);
+
+// Строка для логов: политика и топология
+std::string describePlacement();
+
+}} // namespace Chess::AI
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "core/Move.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace Chess {
+namespace AI {
+
+// Тип оценки, сохраненной в таблице
+enum class Bound : uint8_t {
+    None = 0,
+    Exact,  // Точная оценка (alpha < score < beta)
+    Lower,  // score >= beta (отсечение)
+    Upper   // score <= alpha (ни один ход не улучшил alpha)
+};
+
+struct TTEntry {
+    Move move;
+    int score;      // В формате таблицы (см. scoreToTT)
+    int depth;
+    Bound bound;
+};
+
+// Таблица транспозиций, общая для всех потоков поиска.
+// Запись - два 64-битных слова (ключ XOR данные, данные). Читаются и пишутся
+// без блокировок; запись, разорванная гонкой, не пройдет проверку ключа.
+class TranspositionTable {
+public:
+    explicit TranspositionTable(size_t sizeMb = 16);
+
+    // Изменить размер (содержимое теряется)
+    void resize(size_t sizeMb);
+    void clear();
+
+    // Начало нового поиска: старые записи вытесняются в первую очередь
+    void newSearch() { generation_ = (generation_ + 1) & GENERATION_MASK; }
+
+    bool probe(uint64_t key, TTEntry& entry) const;
+    void store(uint64_t key, const Move& move, int score, int depth, Bound bound);
+
+    // Заполненность в промилле (по выборке первых 1000 записей)
+    int hashfull() const;
+
+    size_t sizeMb() const { return sizeMb_; }
+
+    // Как размещена память при последней очистке (для логов)
+    const std::string& placement() const { return placement_; }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> keyXorData;
+        std::atomic<uint64_t> data;
+    };
+
+    static constexpr uint8_t GENERATION_MASK = 0x3F;
+
+    std::unique_ptr<Slot[]> slots_;
+    size_t mask_ = 0;
+    size_t sizeMb_ = 0;
+    uint8_t generation_ = 0;
+    std::string placement_;
+
+    static uint64_t pack(const Move& move, int score, int depth, Bound bound, uint8_t generation);
+    static TTEntry unpack(uint64_t data);
+    static uint8_t generationOf(uint64_t data);
+};
+
+}} // namespace Chess::AI
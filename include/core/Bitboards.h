@@ -0,0 +1,99 @@
+#pragma once
+
+#include "core/Types.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace Chess {
+namespace Bitboards {
+
+// Атаки фигур в виде битовых досок (бит i - клетка i, a1 = 0).
+// Прыгающие фигуры - готовые таблицы, дальнобойные - лучи до первого блокера.
+
+inline Bitboard squareBB(Square sq) { return Bitboard(1) << sq; }
+
+inline int popCount(Bitboard b) {
+#ifdef _MSC_VER
+    return static_cast<int>(__popcnt64(b));
+#else
+    return __builtin_popcountll(b);
+#endif
+}
+
+// Младший / старший установленный бит (b != 0)
+inline Square lsb(Bitboard b) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, b);
+    return static_cast<Square>(index);
+#else
+    return static_cast<Square>(__builtin_ctzll(b));
+#endif
+}
+
+inline Square msb(Bitboard b) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanReverse64(&index, b);
+    return static_cast<Square>(index);
+#else
+    return static_cast<Square>(63 - __builtin_clzll(b));
+#endif
+}
+
+// Снять и вернуть младший бит
+inline Square popLsb(Bitboard& b) {
+    Square sq = lsb(b);
+    b &= b - 1;
+    return sq;
+}
+
+constexpr Bitboard FILE_A = 0x0101010101010101ULL;
+constexpr Bitboard FILE_H = FILE_A << 7;
+
+inline Bitboard fileBB(int file) { return FILE_A << file; }
+
+// Протянуть биты до края доски вверх / вниз (включая исходные)
+inline Bitboard northFill(Bitboard b) {
+    b |= b << 8;
+    b |= b << 16;
+    b |= b << 32;
+    return b;
+}
+
+inline Bitboard southFill(Bitboard b) {
+    b |= b >> 8;
+    b |= b >> 16;
+    b |= b >> 32;
+    return b;
+}
+
+// Сдвиг на одну вертикаль с отсечением краев
+inline Bitboard shiftEast(Bitboard b) { return (b & ~FILE_H) << 1; }
+inline Bitboard shiftWest(Bitboard b) { return (b & ~FILE_A) >> 1; }
+
+// Маска вертикалей, на которых есть хотя бы один бит (бит i - вертикаль i)
+inline uint8_t filesOf(Bitboard b) {
+    return static_cast<uint8_t>(southFill(b) & 0xFF);
+}
+
+// Клетки, которые бьют пешки цвета color
+inline Bitboard pawnAttacksBB(Bitboard pawns, Color color) {
+    return color == Color::White
+        ? ((pawns & ~FILE_A) << 7) | ((pawns & ~FILE_H) << 9)
+        : ((pawns & ~FILE_A) >> 9) | ((pawns & ~FILE_H) >> 7);
+}
+
+Bitboard pawnAttacks(Color color, Square sq);
+Bitboard knightAttacks(Square sq);
+Bitboard kingAttacks(Square sq);
+Bitboard bishopAttacks(Square sq, Bitboard occupied);
+Bitboard rookAttacks(Square sq, Bitboard occupied);
+
+inline Bitboard queenAttacks(Square sq, Bitboard occupied) {
+    return bishopAttacks(sq, occupied) | rookAttacks(sq, occupied);
+}
+
+}} // namespace Chess::Bitboards
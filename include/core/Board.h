@@ -1,9 +1,13 @@
 #pragma once
 
+#include "core/BoardObserver.h"
 #include "core/Piece.h"
 #include "core/Move.h"
+#include "core/PackedPosition.h"
 #include "core/Position.h"
 #include "core/Types.h"
+#include "core/Zobrist.h"
+#include <algorithm>
 #include <array>
 #include <vector>
 #include <string>
@@ -14,28 +18,108 @@ class Board {
 public:
     Board();
 
+    // Копия доски не наследует наблюдателя; при присваивании наблюдатель
+    // остается у доски-получателя и получает onReset
+    Board(const Board& other);
+    Board& operator=(const Board& other);
+
     // Получить фигуру на клетке
     const Piece& pieceAt(Square sq) const { return squares_[sq]; }
-    Piece& pieceAt(Square sq) { return squares_[sq]; }
 
-    // Установить фигуру
-    void setPiece(Square sq, const Piece& piece) { squares_[sq] = piece; }
-    void removePiece(Square sq) { squares_[sq] = Piece(); }
+    // Установить фигуру (хеши и фаза обновляются инкрементально)
+    void setPiece(Square sq, const Piece& piece) {
+        hash_ ^= Zobrist::piece(squares_[sq], sq) ^ Zobrist::piece(piece, sq);
+        if (squares_[sq].type() == PieceType::Pawn) pawnKey_ ^= Zobrist::piece(squares_[sq], sq);
+        if (piece.type() == PieceType::Pawn) pawnKey_ ^= Zobrist::piece(piece, sq);
+        phase_ += PHASE_WEIGHTS[static_cast<int>(piece.type())] -
+                  PHASE_WEIGHTS[static_cast<int>(squares_[sq].type())];
+        materialKey_ += materialUnit(piece) - materialUnit(squares_[sq]);
+        Bitboard bit = Bitboard(1) << sq;
+        const Piece& old = squares_[sq];
+        if (!old.isNone()) {
+            pieces_[static_cast<int>(old.color())][static_cast<int>(old.type())] &= ~bit;
+            occupied_[static_cast<int>(old.color())] &= ~bit;
+        }
+        if (!piece.isNone()) {
+            pieces_[static_cast<int>(piece.color())][static_cast<int>(piece.type())] |= bit;
+            occupied_[static_cast<int>(piece.color())] |= bit;
+        }
+        if (observer_) {
+            observer_->onPieceChanged(sq, old, piece);
+        }
+        squares_[sq] = piece;
+        codes_[sq] = pieceCode(piece);
+    }
+    void removePiece(Square sq) { setPiece(sq, Piece()); }
+
+    // Наблюдатель за изменениями (один; nullptr - отключить)
+    void setObserver(BoardObserver* observer) { observer_ = observer; }
+    BoardObserver* observer() const { return observer_; }
 
     // Позиция
     const Position& position() const { return position_; }
     Position& position() { return position_; }
 
+    // Битовые доски фигур (поддерживаются в setPiece)
+    Bitboard pieces(Color color, PieceType type) const {
+        return pieces_[static_cast<int>(color)][static_cast<int>(type)];
+    }
+    Bitboard occupied(Color color) const { return occupied_[static_cast<int>(color)]; }
+    Bitboard occupied() const { return occupied_[0] | occupied_[1]; }
+
+    // Коды фигур по клеткам - та же доска в 64 байтах для векторной оценки:
+    // 0 - пусто, иначе тип | цвет << 3 (белые 1-6, черные 9-14)
+    static constexpr int NUM_PIECE_CODES = 16;
+    static uint8_t pieceCode(const Piece& piece) {
+        return piece.isNone() ? 0 : static_cast<uint8_t>(static_cast<int>(piece.type()) |
+                                                         (static_cast<int>(piece.color()) << 3));
+    }
+    const uint8_t* pieceCodes() const { return codes_.data(); }
+
+    // Zobrist-хеш позиции
+    uint64_t hash() const { return hash_; }
+
+    // Хеш одних пешек (ключ таблицы пешечной структуры)
+    uint64_t pawnKey() const { return pawnKey_; }
+
+    // Материальная сигнатура - точное число фигур каждого типа и цвета (кроме
+    // королей) по 4 бита, белые в младших 32 битах: одинаковый материал -
+    // одинаковый ключ. По ней выбираются специальные оценки эндшпилей.
+    uint64_t materialKey() const { return materialKey_; }
+    static constexpr uint64_t PAWN_COUNT_MASK = 0x0000000F0000000FULL;     // Пешки обеих сторон
+    static uint64_t materialUnit(Color color, PieceType type) {
+        return (type == PieceType::None || type == PieceType::King) ? 0 :
+            uint64_t(1) << (static_cast<int>(color) * 32 + (static_cast<int>(type) - 1) * 4);
+    }
+    static uint64_t materialUnit(const Piece& piece) { return materialUnit(piece.color(), piece.type()); }
+
+    // Фаза игры по легким и тяжелым фигурам (конь, слон - 1, ладья - 2, ферзь - 4):
+    // PHASE_MAX - полный комплект (миттельшпиль), 0 - только короли и пешки.
+    // После превращений сумма может превысить максимум - она ограничивается.
+    static constexpr int PHASE_MAX = 24;
+    int gamePhase() const { return std::min(phase_, PHASE_MAX); }
+
     // Сделать/отменить ход
     void makeMove(const Move& move);
     void unmakeMove(const Move& move);
 
+    // Нулевой ход (передача хода) для null-move pruning
+    void makeNullMove();
+    void unmakeNullMove();
+
+    // Есть ли у стороны фигуры кроме пешек и короля
+    bool hasNonPawnMaterial(Color color) const;
+
     // Проверки состояния
     bool isCheck(Color color) const;
     bool isCheckmate(Color color) const;
     bool isStalemate(Color color) const;
     bool isDraw() const;
 
+    // Сколько раз текущая позиция уже встречалась в истории ходов
+    // (только после последнего взятия или хода пешки)
+    int repetitionCount() const;
+
     // Найти короля
     Square findKing(Color color) const;
 
@@ -49,19 +133,54 @@ public:
     void setFromFEN(const std::string& fen);
     std::string toFEN() const;
 
+    // Забыть историю ходов: их больше нельзя отменить, в повторениях они не
+    // участвуют. Для доски, которую переиспользуют для не связанных позиций
+    // (загрузка позиций тюнера, потоки корневого поиска); партия историю хранит.
+    void clearHistory() { history_.clear(); }
+
+    // Компактная двоичная запись (без истории ходов). Загрузка не разбирает
+    // строк и не выделяет память - для массовой оценки позиций.
+    PackedPosition pack() const;
+    void setFromPacked(const PackedPosition& packed);
+
     // Отладочный вывод
     std::string toString() const;
 
 private:
     std::array<Piece, NUM_SQUARES> squares_;
+    alignas(64) std::array<uint8_t, NUM_SQUARES> codes_{};
     Position position_;
+    uint64_t hash_;
+    uint64_t pawnKey_ = 0;
+    uint64_t materialKey_ = 0;
+    int phase_ = 0;
+    Bitboard pieces_[2][7] = {};    // [цвет][тип фигуры], тип None не используется
+    Bitboard occupied_[2] = {};
+
+    // Вклад фигуры в фазу, по PieceType
+    static constexpr int PHASE_WEIGHTS[7] = {0, 0, 1, 1, 2, 4, 0};
 
     // История для отмены ходов
     struct UndoInfo {
         Piece capturedPiece;
         PositionState state;
+        uint64_t hash;
     };
     std::vector<UndoInfo> history_;
+
+    BoardObserver* observer_ = nullptr;
+
+    // Копирование всего, кроме наблюдателя (новые поля доски - сюда)
+    void copyFrom(const Board& other);
+
+    // Очистить доску (хеш пересчитывается вызывающим)
+    void clearSquares();
+
+    // Хеш с нуля (после загрузки позиции)
+    uint64_t computeHash() const;
+
+    // Часть хеша, зависящая от Position (сторона, рокировки, en passant)
+    uint64_t positionStateKey() const;
 };
 
 } // namespace Chess
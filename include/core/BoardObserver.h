@@ -0,0 +1,30 @@
+#pragma once
+
+#include "core/Piece.h"
+#include "core/Types.h"
+
+namespace Chess {
+
+class Board;
+
+// Наблюдатель за изменениями доски - для состояния, которое поддерживается
+// инкрементально вне Board (например, аккумулятор нейросетевой оценки).
+// Вызовы идут из Board::makeMove/unmakeMove и при загрузке позиции.
+class BoardObserver {
+public:
+    virtual ~BoardObserver() = default;
+
+    // Перед изменением фигур хода (и перед нулевым ходом): сохранить состояние
+    virtual void onMakeMove() = 0;
+
+    // Фигура на клетке заменена (removed или added могут быть пустыми)
+    virtual void onPieceChanged(Square sq, const Piece& removed, const Piece& added) = 0;
+
+    // Ход отменен, доска уже восстановлена: вернуть сохраненное состояние
+    virtual void onUnmakeMove() = 0;
+
+    // Позиция загружена заново (FEN, начальная позиция, присваивание доски)
+    virtual void onReset(const Board& board) = 0;
+};
+
+} // namespace Chess
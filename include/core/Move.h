@@ -43,6 +43,10 @@ public:
                flag_ == other.flag_ && promotion_ == other.promotion_;
     }
 
+    bool operator!=(const Move& other) const {
+        return !(*this == other);
+    }
+
 private:
     Square from_;
     Square to_;
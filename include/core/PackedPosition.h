@@ -0,0 +1,25 @@
+#pragma once
+
+#include "core/Types.h"
+#include <cstdint>
+
+namespace Chess {
+
+// Позиция в 32 байтах - запись бинарных файлов позиций (разметка датасетов).
+// Фигуры - коды Board::pieceCode по 4 бита, по клеткам occupied от младшей:
+// четная по счету фигура - в младшем полубайте. Файл - массив таких записей
+// без заголовка, порядок байт - как в памяти (little-endian на x86 и ARM).
+struct PackedPosition {
+    uint64_t occupied;
+    uint8_t pieces[16];
+    uint8_t sideToMove;         // 0 - белые, 1 - черные
+    uint8_t castling;           // Биты: K, Q, k, q
+    uint8_t enPassant;          // Клетка взятия на проходе, 255 - нет
+    uint8_t halfmoveClock;
+    uint16_t fullmoveNumber;
+    uint8_t reserved[2];
+};
+
+static_assert(sizeof(PackedPosition) == 32, "PackedPosition должен занимать 32 байта");
+
+} // namespace Chess
@@ -7,6 +7,7 @@ namespace Chess {
 
 // Состояние позиции для отмены ходов
 struct PositionState {
+    Color sideToMove;
     Square enPassantSquare;
     bool whiteCanCastleKingside;
     bool whiteCanCastleQueenside;
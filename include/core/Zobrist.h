@@ -0,0 +1,25 @@
+#pragma once
+
+#include "core/Piece.h"
+#include "core/Types.h"
+
+namespace Chess {
+namespace Zobrist {
+
+// Ключи Zobrist для хеширования позиции.
+// Хеш позиции = XOR ключей всех фигур, стороны хода, прав на рокировку
+// и вертикали взятия на проходе.
+
+// Ключ фигуры на клетке
+uint64_t piece(const Piece& piece, Square sq);
+
+// Ключ хода черных
+uint64_t sideToMove();
+
+// Ключ права на рокировку (0 - белые O-O, 1 - белые O-O-O, 2 - черные O-O, 3 - черные O-O-O)
+uint64_t castling(int index);
+
+// Ключ вертикали поля взятия на проходе
+uint64_t enPassantFile(int file);
+
+}} // namespace Chess::Zobrist
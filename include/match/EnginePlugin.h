@@ -0,0 +1,39 @@
+#pragma once
+
+// C-интерфейс движка для матчей между разными сборками. Каждая сборка
+// собирает плагин chess_engine_plugin; chess-match загружает два плагина и
+// играет ими. Функции - extern "C", поэтому одинаковые C++-символы двух
+// сборок друг другу не мешают.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(_WIN32)
+#define CHESS_PLUGIN_API __declspec(dllexport)
+#else
+#define CHESS_PLUGIN_API __attribute__((visibility("default")))
+#endif
+
+// options - строка настроек в формате chess-match ("depth=6,hash=32,lmr=0")
+CHESS_PLUGIN_API void* chess_plugin_create(const char* options);
+CHESS_PLUGIN_API void chess_plugin_destroy(void* player);
+CHESS_PLUGIN_API void chess_plugin_new_game(void* player);
+
+// Позиция - стартовый FEN и ходы партии после него ("e2e4 e7e5 e1g1 e7e8q"),
+// чтобы движок видел историю для повторений. Нулевые лимиты не действуют.
+// Ход пишется в moveOut в том же формате, оценка - в scoreOut (за сторону на ходу).
+// Возвращает 0 при успехе.
+CHESS_PLUGIN_API int chess_plugin_think(void* player, const char* fen, const char* moves,
+                                        int depth, unsigned long long nodes, int moveTimeMs,
+                                        char* moveOut, int moveOutSize, int* scoreOut);
+
+typedef void* (*ChessPluginCreateFn)(const char*);
+typedef void (*ChessPluginDestroyFn)(void*);
+typedef void (*ChessPluginNewGameFn)(void*);
+typedef int (*ChessPluginThinkFn)(void*, const char*, const char*, int, unsigned long long, int,
+                                  char*, int, int*);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "match/Player.h"
+#include "match/Sprt.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace Chess {
+namespace Match {
+
+struct MatchOptions {
+    int concurrency = 1;                // Партий одновременно
+    int maxGames = 1000;                // Предел, если SPRT не остановит раньше
+    std::vector<std::string> openings;  // FEN; каждый играется дважды со сменой цвета
+
+    // Контроль: лимиты на ход и/или часы (база + добавка, мс)
+    SearchLimits limits;
+    int baseTimeMs = 0;
+    int incrementMs = 0;
+
+    // Адъюдикация. Победа: оба движка подряд resignMoves ходов каждый согласны,
+    // что перевес не меньше resignScore. Ничья: после хода drawMoveNumber
+    // оценки обоих по модулю не больше drawScore drawMoves ходов каждый.
+    int resignScore = 1000;
+    int resignMoves = 3;
+    int drawMoveNumber = 40;
+    int drawScore = 10;
+    int drawMoves = 8;
+    int maxPlies = 400;                 // Дальше - ничья
+
+    // SPRT (выключен, если sprtEnabled = false)
+    bool sprtEnabled = false;
+    double elo0 = 0.0;
+    double elo1 = 5.0;
+    double alpha = 0.05;
+    double beta = 0.05;
+
+    int reportEvery = 10;               // Строка прогресса каждые N партий
+};
+
+enum class GameOutcome { WhiteWins, BlackWins, Draw };
+
+struct GameRecord {
+    GameOutcome outcome = GameOutcome::Draw;
+    std::string reason;
+    int plies = 0;
+};
+
+// Матч двух движков: партии идут параллельно в concurrency потоках, у каждого
+// потока своя пара движков. Счет - с точки зрения первого движка.
+class MatchRunner {
+public:
+    MatchRunner(PlayerConfig first, PlayerConfig second, MatchOptions options);
+
+    // false и error, если движки не создались
+    bool run(std::ostream& out, MatchScore& score, std::string& error);
+
+    // Встроенный набор дебютов, если файл не задан
+    static std::vector<std::string> defaultOpenings();
+
+    // FEN и EPD (первые четыре поля), по позиции в строке; # - комментарий
+    static bool loadOpenings(const std::string& path, std::vector<std::string>& openings,
+                             std::string& error);
+
+private:
+    PlayerConfig first_;
+    PlayerConfig second_;
+    MatchOptions options_;
+
+    std::mutex mutex_;                  // Счет, вывод, решение SPRT
+    std::atomic<int> nextGame_{0};
+    std::atomic<bool> finished_{false};
+
+    GameRecord playGame(Player& white, Player& black, const std::string& fen);
+};
+
+}} // namespace Chess::Match
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "core/Board.h"
+#include "core/Move.h"
+#include "ai/Engine.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Chess {
+namespace Match {
+
+// Ограничения на один ход (нулевые не действуют)
+struct SearchLimits {
+    int depth = 0;
+    uint64_t nodes = 0;
+    int moveTimeMs = 0;
+};
+
+struct PlayerMove {
+    Move move;
+    int score = 0;      // За сторону, сделавшую ход
+};
+
+// Участник матча
+class Player {
+public:
+    virtual ~Player() = default;
+
+    virtual void newGame() {}
+
+    // board - текущая позиция (с историей ходов), startFen и moves - та же
+    // позиция в виде "стартовый FEN + ходы" для плагинов
+    virtual PlayerMove think(const Board& board, const std::string& startFen,
+                             const std::vector<Move>& moves, const SearchLimits& limits) = 0;
+};
+
+// Настройки участника из строки "name=new,depth=6,hash=32,lmr=0,backend=mcts",
+// "nnue=net.nnue,depth=6" или "plugin=./libchess_engine_plugin_old.so,depth=6"
+struct PlayerConfig {
+    std::string name;
+    std::string backend = "alphabeta";      // alphabeta | mcts
+    std::string pluginPath;                 // Непустой - движок из плагина
+    std::string nnuePath;                   // Непустой - нейросетевая оценка из файла
+    std::string options;                    // Исходная строка (передается плагину)
+    int depth = 0;                          // 0 - без ограничения глубины
+    size_t hashMb = 16;
+    int threads = 1;                        // Потоков на движок (MCTS)
+    AI::SearchParams params;
+};
+
+bool parsePlayerConfig(const std::string& text, PlayerConfig& config, std::string& error);
+
+// nullptr и error при ошибке (например, плагин не загрузился)
+std::unique_ptr<Player> createPlayer(const PlayerConfig& config, std::string& error);
+
+// Ходы в формате "e2e4", "e7e8q"
+std::string moveToUci(const Move& move);
+Move parseUciMove(const Board& board, const std::string& text);  // Move() - нет такого хода
+
+}} // namespace Chess::Match
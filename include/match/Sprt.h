@@ -0,0 +1,53 @@
+#pragma once
+
+#include <string>
+
+namespace Chess {
+namespace Match {
+
+// Счет матча с точки зрения первого движка
+struct MatchScore {
+    int wins = 0;
+    int draws = 0;
+    int losses = 0;
+
+    int games() const { return wins + draws + losses; }
+    double scoreRatio() const;      // Доля очков (0..1)
+};
+
+// Оценка разницы в силе по счету
+struct EloEstimate {
+    double elo = 0.0;
+    double errorMargin = 0.0;       // Полуширина 95% доверительного интервала
+    double los = 0.5;               // Likelihood of superiority
+};
+
+EloEstimate estimateElo(const MatchScore& score);
+
+// Последовательный тест отношения правдоподобия: H0 - разница elo0, H1 - elo1.
+// LLR считается в нормальном приближении по триномиальной модели (W/D/L).
+class Sprt {
+public:
+    enum class Decision { Continue, AcceptH0, AcceptH1 };
+
+    Sprt(double elo0, double elo1, double alpha = 0.05, double beta = 0.05);
+
+    double llr(const MatchScore& score) const;
+    Decision decide(const MatchScore& score) const;
+
+    double lowerBound() const { return lowerBound_; }
+    double upperBound() const { return upperBound_; }
+    double elo0() const { return elo0_; }
+    double elo1() const { return elo1_; }
+
+private:
+    double elo0_;
+    double elo1_;
+    double lowerBound_;
+    double upperBound_;
+};
+
+// Строка прогресса: счет, Elo, LOS и (если задан) LLR
+std::string formatProgress(const MatchScore& score, const Sprt* sprt);
+
+}} // namespace Chess::Match
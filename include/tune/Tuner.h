@@ -0,0 +1,77 @@
+#pragma once
+
+#include "ai/EvalParams.h"
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace Chess {
+namespace Tune {
+
+// Настройки тюнинга
+struct TuneOptions {
+    int threads = 1;
+    size_t maxPositions = 0;        // 0 - все позиции файла
+    bool quiesce = true;            // Заменять позицию спокойным листом quiescence
+    double k = 0.0;                 // Масштаб сигмоиды; 0 - подобрать по данным
+    int epochs = 1000;
+    double learningRate = 1.0;      // Шаг Adam, в сантипешках
+    int reportEvery = 50;           // Печатать ошибку каждые N эпох
+};
+
+// Texel-тюнинг параметров классической оценки: минимизация среднеквадратичной
+// ошибки между результатом партии и sigmoid(K * оценка / 400) градиентным спуском.
+// Оценка линейна по параметрам, поэтому каждая позиция хранится как разреженный
+// вектор коэффициентов (EvalTrace) - эпоха не вызывает Evaluator вовсе.
+class Tuner {
+public:
+    explicit Tuner(const TuneOptions& options);
+
+    // Загрузить позиции с результатами: EPD/FEN, результат - "1-0", "0-1",
+    // "1/2-1/2" или [1.0], [0.5], [0.0] после полей позиции. Позиции
+    // разбираются, разрешаются quiescence и раскладываются на всех потоках.
+    bool load(const std::string& path, std::ostream& out, std::string& error);
+
+    size_t size() const { return positions_.size(); }
+
+    // Подобрать K, минимизирующий ошибку при данных параметрах
+    double findK(const AI::EvalParams& params) const;
+
+    // Средняя ошибка при данных параметрах
+    double error(const AI::EvalParams& params, double k) const;
+
+    // Настроить params; прогресс - в out
+    void tune(AI::EvalParams& params, std::ostream& out);
+
+    // Исходник src/ai/EvalParams.cpp с данными параметрами
+    static void writeSource(const AI::EvalParams& params, std::ostream& out);
+
+private:
+    // Ненулевой коэффициент параметра в позиции
+    struct Coefficient {
+        uint16_t index;
+        int16_t value;
+    };
+
+    // Позиция: ее коэффициенты - coefficients_[first, first + count)
+    struct Position {
+        uint32_t first;
+        uint16_t count;
+        uint8_t phase;
+        uint8_t result;             // 0 - победа черных, 1 - ничья, 2 - победа белых
+        uint8_t scale;              // Множитель эндшпильной части (Endgames::SCALE_NORMAL - без изменений)
+    };
+
+    TuneOptions options_;
+    std::vector<Position> positions_;
+    std::vector<Coefficient> coefficients_;
+
+    // Параметры в виде плоского массива: mg и eg подряд
+    static std::vector<double> flatten(const AI::EvalParams& params);
+
+    // Ошибка и (если gradient не nullptr) ее градиент по плоским параметрам
+    double evaluateError(const std::vector<double>& weights, double k, std::vector<double>* gradient) const;
+};
+
+}} // namespace Chess::Tune
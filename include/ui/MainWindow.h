@@ -5,7 +5,9 @@
 #include <QListWidget>
 #include <QComboBox>
 #include <QPushButton>
+#include <QTimer>
 #include <memory>
+#include <future>
 #include "ui/ChessBoard.h"
 #include "core/Board.h"
 #include "ai/Engine.h"
@@ -27,20 +29,32 @@ private slots:
     void onDifficultyChanged(int index);
     void onUndoMove();
     void onAiMove();
+    void onAnalysisToggled(bool checked);
+    void onAnalysisTimer();
 
 private:
     // UI компоненты
     ChessBoard* chessBoard_;
     QLabel* statusLabel_;
+    QLabel* pvLabel_;
     QListWidget* moveList_;
     QComboBox* difficultyCombo_;
     QPushButton* newGameButton_;
     QPushButton* undoButton_;
+    QPushButton* analysisButton_;
+    QTimer* analysisTimer_;
 
     // Игровая логика
     std::shared_ptr<Board> board_;
     std::unique_ptr<AI::Engine> aiEngine_;
     
+    // Пондеринг: отдельный движок на своей доске (позиция после ожидаемого
+    // ответа игрока), общая с aiEngine_ таблица транспозиций
+    std::unique_ptr<Board> ponderBoard_;
+    std::unique_ptr<AI::Engine> ponderEngine_;
+    std::future<AI::SearchResult> ponderFuture_;
+    Move ponderMove_;
+    
     // Состояние игры
     bool playingAgainstAi_;
     Color playerColor_;
@@ -62,6 +76,10 @@ private:
     
     // AI
     void triggerAiMove();
+    void playAiMove(const AI::SearchResult& result);
+    void startPondering(const AI::SearchResult& result);
+    void stopPondering();
+    void stopAnalysis();
 };
 
 }} // namespace Chess::UI
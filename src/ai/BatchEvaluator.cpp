@@ -0,0 +1,217 @@
+#include "ai/BatchEvaluator.h"
+#include "ai/Engine.h"
+#include "ai/Evaluator.h"
+#include "ai/Nnue.h"
+#include "ai/PawnHashTable.h"
+#include "ai/Score.h"
+#include "ai/ThreadPlacement.h"
+#include "ai/TranspositionTable.h"
+#include "core/Board.h"
+#include <algorithm>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define CHESS_BATCH_HAVE_MMAP 1
+#endif
+
+namespace Chess {
+namespace AI {
+
+namespace {
+
+// Позиций за один захват счетчика: реже дергать общий атомик, но хвост
+// пакета все равно делится между потоками
+constexpr size_t CHUNK_SIZE = 256;
+
+#ifdef CHESS_BATCH_HAVE_MMAP
+// Файл, отображенный в память целиком
+class MappedFile {
+public:
+    ~MappedFile() {
+        if (data_) munmap(data_, size_);
+        if (fd_ >= 0) close(fd_);
+    }
+
+    bool openRead(const std::string& path, std::string& error) {
+        fd_ = open(path.c_str(), O_RDONLY);
+        struct stat info;
+        if (fd_ < 0 || fstat(fd_, &info) != 0) {
+            error = "не удалось открыть " + path;
+            return false;
+        }
+        size_ = static_cast<size_t>(info.st_size);
+        return map(PROT_READ, path, error);
+    }
+
+    bool create(const std::string& path, size_t size, std::string& error) {
+        fd_ = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd_ < 0 || ftruncate(fd_, static_cast<off_t>(size)) != 0) {
+            error = "не удалось создать " + path;
+            return false;
+        }
+        size_ = size;
+        return map(PROT_READ | PROT_WRITE, path, error);
+    }
+
+    void* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    int fd_ = -1;
+    void* data_ = nullptr;
+    size_t size_ = 0;
+
+    bool map(int protection, const std::string& path, std::string& error) {
+        if (size_ == 0) {
+            return true;    // Пустой файл не отображается
+        }
+        void* data = mmap(nullptr, size_, protection, MAP_SHARED, fd_, 0);
+        if (data == MAP_FAILED) {
+            error = "не удалось отобразить в память " + path;
+            return false;
+        }
+        data_ = data;
+        madvise(data_, size_, MADV_SEQUENTIAL);
+        return true;
+    }
+};
+#endif
+
+} // namespace
+
+// Состояние потока: доска и все, что к ней привязано. Движок нужен только
+// для quiescence; таблица транспозиций ему - минимальная, quiescence ее не читает.
+struct BatchEvaluator::Worker {
+    Board board;
+    PawnHashTable pawnTable;
+    std::unique_ptr<Engine> engine;
+
+    explicit Worker(const BatchOptions& options) {
+        if (options.mode == BatchMode::Quiescence) {
+            engine = std::make_unique<Engine>(board, std::make_shared<TranspositionTable>(1));
+            engine->setLogFile("");
+            engine->setNnue(options.network);
+        }
+    }
+};
+
+BatchEvaluator::BatchEvaluator(const BatchOptions& options) : options_(options) {
+    options_.threads = std::max(1, options_.threads);
+    for (int i = 0; i < options_.threads; ++i) {
+        workers_.push_back(std::make_unique<Worker>(options_));
+    }
+    for (int i = 1; i < options_.threads; ++i) {
+        threads_.emplace_back(&BatchEvaluator::threadLoop, this, i);
+    }
+}
+
+BatchEvaluator::~BatchEvaluator() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+void BatchEvaluator::evaluate(const PackedPosition* positions, size_t count, int16_t* scores) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        positions_ = positions;
+        scores_ = scores;
+        count_ = count;
+        next_.store(0, std::memory_order_relaxed);
+        pending_ = static_cast<int>(threads_.size());
+        generation_++;
+    }
+    wake_.notify_all();
+
+    process(*workers_[0]);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this] { return pending_ == 0; });
+}
+
+void BatchEvaluator::threadLoop(int index) {
+    pinCurrentThread(index);
+    uint64_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+            if (stop_) {
+                return;
+            }
+            seen = generation_;
+        }
+
+        process(*workers_[index]);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--pending_ == 0) {
+            done_.notify_one();
+        }
+    }
+}
+
+void BatchEvaluator::process(Worker& worker) {
+    while (true) {
+        size_t first = next_.fetch_add(CHUNK_SIZE, std::memory_order_relaxed);
+        if (first >= count_) {
+            return;
+        }
+        size_t last = std::min(first + CHUNK_SIZE, count_);
+        for (size_t i = first; i < last; ++i) {
+            worker.board.setFromPacked(positions_[i]);
+            Color side = worker.board.position().sideToMove();
+
+            int score;
+            if (worker.engine) {
+                score = worker.engine->quiescenceScore(side);
+            } else if (options_.network) {
+                score = Nnue::Accumulator::evaluateFull(*options_.network, worker.board);
+            } else {
+                score = Evaluator(worker.board, &worker.pawnTable).evaluate();
+                if (side == Color::Black) score = -score;
+            }
+            scores_[i] = static_cast<int16_t>(std::max(-SCORE_INFINITY, std::min(score, SCORE_INFINITY)));
+        }
+    }
+}
+
+bool BatchEvaluator::evaluateFile(const std::string& inputPath, const std::string& outputPath, size_t& count,
+                                  std::string& error) {
+#ifdef CHESS_BATCH_HAVE_MMAP
+    MappedFile input;
+    if (!input.openRead(inputPath, error)) {
+        return false;
+    }
+    if (input.size() % sizeof(PackedPosition) != 0) {
+        error = inputPath + ": размер не кратен " + std::to_string(sizeof(PackedPosition)) + " байтам";
+        return false;
+    }
+    count = input.size() / sizeof(PackedPosition);
+
+    MappedFile output;
+    if (!output.create(outputPath, count * sizeof(int16_t), error)) {
+        return false;
+    }
+    if (count > 0) {
+        evaluate(static_cast<const PackedPosition*>(input.data()), count, static_cast<int16_t*>(output.data()));
+    }
+    return true;
+#else
+    (void)inputPath;
+    (void)outputPath;
+    count = 0;
+    error = "отображение файлов в память не поддерживается на этой платформе";
+    return false;
+#endif
+}
+
+}} // namespace Chess::AI
@@ -0,0 +1,273 @@
+#include "ai/Bench.h"
+#include "ai/Bitbase.h"
+#include "ai/Engine.h"
+#include "ai/Evaluator.h"
+#include "ai/Nnue.h"
+#include "ai/ThreadPlacement.h"
+#include "core/Board.h"
+#include "core/MoveGenerator.h"
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace Chess {
+namespace AI {
+
+namespace {
+
+// Дебют, миттельшпиль, тактика, эндшпиль
+const char* const BENCH_POSITIONS[] = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+    "r5rk/5p1p/5R2/4B3/8/8/7P/7K w - - 0 1",
+    "6k1/5p2/6p1/8/7p/8/6PP/6K1 b - - 0 1",
+    "8/8/1p1k4/5ppp/PPK1p3/6P1/5PP1/8 b - - 0 1",
+};
+
+constexpr int PLAYOUT_PLIES = 40;
+constexpr uint32_t PLAYOUT_SEED = 20240601;
+constexpr double KERNEL_BENCH_SECONDS = 0.2;
+
+// Поиск по позициям бенчмарка одной из оценок; узлы в секунду
+uint64_t searchNps(std::shared_ptr<const Nnue::Network> network, int depth) {
+    uint64_t nodes = 0;
+    double time = 0.0;
+    for (const char* fen : BENCH_POSITIONS) {
+        Board board;
+        board.setFromFEN(fen);
+        Engine engine(board);
+        engine.setLogFile("");
+        engine.setDeterministic(true);
+        engine.setNnue(network);
+        SearchResult search = engine.findBestMove(board.position().sideToMove(), depth);
+        nodes += static_cast<uint64_t>(search.nodesSearched);
+        time += search.timeSpent;
+    }
+    return time > 0 ? static_cast<uint64_t>(nodes / time) : 0;
+}
+
+// Позиции бенчмарка и случайные партии из них (зерно то же, что у NNUE-бенчмарка)
+std::vector<Board> playoutSamples() {
+    std::vector<Board> samples;
+    std::mt19937 rng(PLAYOUT_SEED);
+    for (const char* fen : BENCH_POSITIONS) {
+        Board board;
+        board.setFromFEN(fen);
+        samples.push_back(board);
+        for (int ply = 0; ply < PLAYOUT_PLIES; ++ply) {
+            MoveGenerator generator(board);
+            std::vector<Move> moves = generator.generateLegalMoves(board.position().sideToMove());
+            if (moves.empty()) break;
+            board.makeMove(moves[rng() % moves.size()]);
+            samples.push_back(board);
+        }
+    }
+    return samples;
+}
+
+} // namespace
+
+BenchResult runBench(int depth, std::ostream* out, bool deterministic) {
+    BenchResult result;
+    if (out) {
+        *out << "Размещение: " << describePlacement() << "\n"
+             << "Битовая база KPK: " << Bitbases::kpkSizeBytes() / 1024 << " КБ, построена за "
+             << Bitbases::kpkGenerationMs() << " мс\n";
+    }
+    
+    for (const char* fen : BENCH_POSITIONS) {
+        Board board;
+        board.setFromFEN(fen);
+        Engine engine(board);
+        engine.setLogFile("");
+        engine.setDeterministic(deterministic);
+        
+        SearchResult search = engine.findBestMove(board.position().sideToMove(), depth);
+        result.nodes += static_cast<uint64_t>(search.nodesSearched);
+        result.timeSpent += search.timeSpent;
+        
+        if (out) {
+            *out << fen << "\n  " << search.bestMove.toLongAlgebraic()
+                 << " " << search.score << " узлов " << search.nodesSearched << "\n";
+        }
+    }
+    
+    result.nps = result.timeSpent > 0 ? static_cast<uint64_t>(result.nodes / result.timeSpent) : 0;
+    if (out) {
+        *out << "===========================\n"
+             << "Время:  " << result.timeSpent << " с\n"
+             << "Узлов:  " << result.nodes << "\n"
+             << "Узл/с:  " << result.nps << "\n";
+    }
+    return result;
+}
+
+NnueBenchResult runNnueBench(std::shared_ptr<const Nnue::Network> network, int depth, std::ostream* out) {
+    NnueBenchResult result;
+    std::vector<Board> samples;
+    
+    // Случайные партии: на каждом ходе и на каждой отмене инкрементальный
+    // аккумулятор сверяется с пересчетом с нуля
+    std::mt19937 rng(PLAYOUT_SEED);
+    for (const char* fen : BENCH_POSITIONS) {
+        Board board;
+        board.setFromFEN(fen);
+        Nnue::Accumulator accumulator(network);
+        accumulator.attach(board);
+        
+        auto check = [&]() {
+            Color side = board.position().sideToMove();
+            if (accumulator.evaluate(side) != Nnue::Accumulator::evaluateFull(*network, board)) {
+                result.incrementalExact = false;
+            }
+        };
+        
+        std::vector<Move> played;
+        samples.push_back(board);
+        check();
+        for (int ply = 0; ply < PLAYOUT_PLIES; ++ply) {
+            MoveGenerator generator(board);
+            std::vector<Move> moves = generator.generateLegalMoves(board.position().sideToMove());
+            if (moves.empty()) break;
+            Move move = moves[rng() % moves.size()];
+            board.makeMove(move);
+            played.push_back(move);
+            samples.push_back(board);
+            check();
+        }
+        while (!played.empty()) {
+            board.unmakeMove(played.back());
+            played.pop_back();
+            check();
+        }
+    }
+    result.positions = static_cast<int>(samples.size());
+    
+    // Точность: обе оценки за белых
+    double sumDiff = 0.0, sumX = 0.0, sumY = 0.0, sumXX = 0.0, sumYY = 0.0, sumXY = 0.0;
+    int sameSign = 0;
+    for (const Board& board : samples) {
+        double classic = Evaluator(board).evaluate();
+        double nnue = Nnue::Accumulator::evaluateFull(*network, board);
+        if (board.position().sideToMove() == Color::Black) nnue = -nnue;
+        
+        sumDiff += std::abs(nnue - classic);
+        sumX += classic;
+        sumY += nnue;
+        sumXX += classic * classic;
+        sumYY += nnue * nnue;
+        sumXY += classic * nnue;
+        if ((classic >= 0) == (nnue >= 0)) sameSign++;
+    }
+    double n = result.positions;
+    double covariance = sumXY / n - (sumX / n) * (sumY / n);
+    double varianceX = sumXX / n - (sumX / n) * (sumX / n);
+    double varianceY = sumYY / n - (sumY / n) * (sumY / n);
+    result.meanAbsDiff = sumDiff / n;
+    result.correlation = (varianceX > 0 && varianceY > 0) ? covariance / std::sqrt(varianceX * varianceY) : 0.0;
+    result.signAgreement = sameSign / n;
+    
+    if (out) {
+        *out << "NNUE: позиций " << result.positions
+             << " | средняя |NNUE - классика| " << result.meanAbsDiff
+             << " | корреляция " << result.correlation
+             << " | совпадение знака " << result.signAgreement * 100.0 << "%\n"
+             << "Инкрементальный аккумулятор = пересчет: " << (result.incrementalExact ? "да" : "НЕТ") << "\n";
+    }
+    
+    // Ядра: каждый доступный набор инструкций против скалярного
+    Nnue::SimdLevel detected = Nnue::detectedSimdLevel();
+    std::vector<int> reference;
+    for (int level = 0; level <= static_cast<int>(detected); ++level) {
+        Nnue::setSimdLevel(static_cast<Nnue::SimdLevel>(level));
+        
+        std::vector<int> scores;
+        for (const Board& board : samples) {
+            scores.push_back(Nnue::Accumulator::evaluateFull(*network, board));
+        }
+        if (reference.empty()) {
+            reference = scores;
+        } else if (scores != reference) {
+            result.kernelsExact = false;
+        }
+        
+        uint64_t evaluations = 0;
+        auto start = std::chrono::steady_clock::now();
+        double elapsed = 0.0;
+        while (elapsed < KERNEL_BENCH_SECONDS) {
+            for (const Board& board : samples) {
+                Nnue::Accumulator::evaluateFull(*network, board);
+            }
+            evaluations += samples.size();
+            elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+        if (out) {
+            *out << "Ядро " << Nnue::simdLevelName(static_cast<Nnue::SimdLevel>(level))
+                 << ": " << static_cast<uint64_t>(evaluations / elapsed) << " оценок/с (с нуля)\n";
+        }
+    }
+    Nnue::setSimdLevel(detected);
+    
+    result.classicNps = searchNps(nullptr, depth);
+    result.nnueNps = searchNps(network, depth);
+    if (out) {
+        *out << "Ядра совпадают: " << (result.kernelsExact ? "да" : "НЕТ") << "\n"
+             << "Поиск на глубину " << depth << ": классика " << result.classicNps
+             << " узл/с, NNUE (" << Nnue::simdLevelName(detected) << ") " << result.nnueNps << " узл/с\n";
+    }
+    return result;
+}
+
+EvalBenchResult runEvalBench(int depth, std::ostream* out) {
+    EvalBenchResult result;
+    std::vector<Board> samples = playoutSamples();
+    result.positions = static_cast<int>(samples.size());
+    
+    // Каждое ядро против эталона - скалярного обхода по фигурам
+    PieceKernel detected = Evaluator::detectedPieceKernel();
+    std::vector<int> reference;
+    for (int kernel = 0; kernel <= static_cast<int>(detected); ++kernel) {
+        Evaluator::setPieceKernel(static_cast<PieceKernel>(kernel));
+        
+        std::vector<int> scores;
+        for (const Board& board : samples) {
+            scores.push_back(Evaluator(board).evaluate());
+        }
+        if (reference.empty()) {
+            reference = scores;
+        } else if (scores != reference) {
+            result.kernelsExact = false;
+        }
+        
+        PawnHashTable pawnTable;
+        uint64_t evaluations = 0;
+        auto start = std::chrono::steady_clock::now();
+        double elapsed = 0.0;
+        while (elapsed < KERNEL_BENCH_SECONDS) {
+            for (const Board& board : samples) {
+                Evaluator(board, &pawnTable).evaluate();
+            }
+            evaluations += samples.size();
+            elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+        uint64_t nps = searchNps(nullptr, depth);
+        if (out) {
+            *out << "Ядро " << Evaluator::pieceKernelName(static_cast<PieceKernel>(kernel))
+                 << ": " << static_cast<uint64_t>(evaluations / elapsed) << " оценок/с, поиск на глубину "
+                 << depth << " " << nps << " узл/с" << "\n";
+        }
+    }
+    Evaluator::setPieceKernel(detected);
+    
+    if (out) {
+        *out << "Оценка: позиций " << result.positions
+             << " | ядра совпадают с эталоном: " << (result.kernelsExact ? "да" : "НЕТ") << "\n";
+    }
+    return result;
+}
+
+}} // namespace Chess::AI
@@ -0,0 +1,248 @@
+#include "ai/Bitbase.h"
+#include "core/Bitboards.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <vector>
+
+namespace Chess {
+namespace AI {
+namespace Bitbases {
+
+namespace {
+
+// Позиции базы - со стороны белых (у них пешка): индекс = поле белого короля
+// | поле черного << 6 | ход черных << 12 | поле пешки << 13, где поле пешки -
+// номер 0..23: (горизонталь - 1) * 4 + вертикаль, пешка на вертикалях a-d.
+constexpr int PAWN_SLOTS = 24;
+constexpr int MAX_INDEX = 2 * PAWN_SLOTS * NUM_SQUARES * NUM_SQUARES;
+
+int indexOf(int blackToMove, Square blackKing, Square whiteKing, Square pawn) {
+    int slot = (getRank(pawn) - 1) * 4 + getFile(pawn);
+    return whiteKing | (blackKing << 6) | (blackToMove << 12) | (slot << 13);
+}
+
+int distance(Square a, Square b) {
+    return std::max(std::abs(getFile(a) - getFile(b)), std::abs(getRank(a) - getRank(b)));
+}
+
+// Результаты при построении. Ретроградный анализ: от выигранных позиций назад
+// по ходам к их предшественникам. Белым на ходу достаточно одного хода в
+// выигрыш; черные на ходу проиграли, когда в выигрыш ведут все их ходы - их
+// считает счетчик. Ничьи не распространяются: все, что не стало выигрышем, -
+// ничья.
+enum Result : uint8_t {
+    INVALID = 0,
+    UNKNOWN = 1,
+    DRAW = 2,
+    WIN = 4
+};
+
+class KpkBuilder {
+public:
+    KpkBuilder() : db_(MAX_INDEX), movesLeft_(MAX_INDEX, 0) {
+        // Таблицы атак из Bitboards могут быть еще не построены: база
+        // строится при статической инициализации, порядок между файлами не задан
+        for (Square from = 0; from < NUM_SQUARES; ++from) {
+            kingBB_[from] = 0;
+            kingMovesCount_[from] = 0;
+            for (Square to = 0; to < NUM_SQUARES; ++to) {
+                if (to != from && distance(from, to) == 1) {
+                    kingBB_[from] |= Bitboards::squareBB(to);
+                    kingMoves_[from][kingMovesCount_[from]++] = to;
+                }
+            }
+        }
+    }
+
+    // Итог - бит на позицию, 1 - выигрыш белых
+    std::vector<uint64_t> build() {
+        std::vector<int> resolved;
+        resolved.reserve(MAX_INDEX);
+        // Перебор в порядке индекса, без разбора каждого индекса на поля
+        int idx = 0;
+        for (int slot = 0; slot < PAWN_SLOTS; ++slot) {
+            for (int blackToMove = 0; blackToMove < 2; ++blackToMove) {
+                for (Square blackKing = 0; blackKing < NUM_SQUARES; ++blackKing) {
+                    for (Square whiteKing = 0; whiteKing < NUM_SQUARES; ++whiteKing, ++idx) {
+                        Decoded p{whiteKing, blackKing, makeSquare(slot % 4, slot / 4 + 1), blackToMove != 0};
+                        db_[idx] = classifyInitial(idx, p);
+                        if (db_[idx] == WIN) resolved.push_back(idx);
+                    }
+                }
+            }
+        }
+
+        // resolved растет по ходу обхода: новые выигрыши встают в конец
+        for (size_t i = 0; i < resolved.size(); ++i) {
+            forEachPredecessor(resolved[i], [&](int prev) {
+                bool blackToMove = (prev >> 12) & 1;
+                if (db_[prev] == UNKNOWN && (!blackToMove || --movesLeft_[prev] == 0)) {
+                    db_[prev] = WIN;
+                    resolved.push_back(prev);
+                }
+            });
+        }
+
+        std::vector<uint64_t> bits(MAX_INDEX / 64, 0);
+        for (int idx = 0; idx < MAX_INDEX; ++idx) {
+            if (db_[idx] == WIN) bits[idx / 64] |= uint64_t(1) << (idx % 64);
+        }
+        return bits;
+    }
+
+private:
+    std::vector<uint8_t> db_;
+    std::vector<uint8_t> movesLeft_;    // Черным на ходу: ходов, еще не ведущих в выигрыш
+    Bitboard kingBB_[NUM_SQUARES];
+    Square kingMoves_[NUM_SQUARES][8];
+    int kingMovesCount_[NUM_SQUARES];
+
+    struct Decoded {
+        Square whiteKing;
+        Square blackKing;
+        Square pawn;
+        bool blackToMove;
+    };
+
+    static Decoded decode(int idx) {
+        int slot = idx >> 13;
+        return {static_cast<Square>(idx & 63), static_cast<Square>((idx >> 6) & 63),
+                makeSquare(slot % 4, slot / 4 + 1), ((idx >> 12) & 1) != 0};
+    }
+
+    // Исход, известный без перебора: невозможная позиция, превращение без
+    // взятия ферзя, пат, взятие незащищенной пешки
+    Result classifyInitial(int idx, const Decoded& p) {
+        Bitboard whiteKing = Bitboards::squareBB(p.whiteKing);
+        Bitboard blackKing = Bitboards::squareBB(p.blackKing);
+        Bitboard pawnAttacks = Bitboards::pawnAttacksBB(Bitboards::squareBB(p.pawn), Color::White);
+        if ((kingBB_[p.whiteKing] & blackKing) || p.whiteKing == p.blackKing || p.whiteKing == p.pawn ||
+            p.blackKing == p.pawn || (!p.blackToMove && (pawnAttacks & blackKing))) {
+            return INVALID;
+        }
+
+        if (!p.blackToMove) {
+            Square queening = static_cast<Square>(p.pawn + 8);
+            if (getRank(p.pawn) == 6 && queening != p.whiteKing && queening != p.blackKing &&
+                (!(kingBB_[queening] & blackKing) || (kingBB_[queening] & whiteKing))) {
+                return WIN;
+            }
+            return UNKNOWN;
+        }
+
+        Bitboard covered = kingBB_[p.whiteKing] | pawnAttacks;
+        bool inCheck = (pawnAttacks & blackKing) != 0;
+        if (!inCheck && !(kingBB_[p.blackKing] & ~covered)) {
+            return DRAW;
+        }
+        if ((kingBB_[p.pawn] & blackKing) && !(kingBB_[p.pawn] & whiteKing)) {
+            return DRAW;
+        }
+        // Ходов нет, а король под шахом - мат
+        movesLeft_[idx] = static_cast<uint8_t>(countBlackMoves(p));
+        return movesLeft_[idx] ? UNKNOWN : WIN;
+    }
+
+    // Ходы черного короля не под бой. Взятие пешки учтено в classifyInitial:
+    // незащищенная - ничья, защищенная - под боем короля.
+    int countBlackMoves(const Decoded& p) const {
+        Bitboard pawn = Bitboards::squareBB(p.pawn);
+        Bitboard pawnAttacks = Bitboards::pawnAttacksBB(pawn, Color::White);
+        return Bitboards::popCount(kingBB_[p.blackKing] & ~(kingBB_[p.whiteKing] | pawnAttacks | pawn));
+    }
+
+    // Обратные ходы: позиции, из которых ход приводит в idx. У белых - ходы
+    // королем и пешкой (на одно и два поля), превращение учтено в
+    // classifyInitial.
+    template <typename Fn>
+    void forEachPredecessor(int idx, Fn fn) const {
+        Decoded p = decode(idx);
+        if (!p.blackToMove) {
+            for (int i = 0; i < kingMovesCount_[p.blackKing]; ++i) {
+                Square from = kingMoves_[p.blackKing][i];
+                if (from != p.pawn) fn(indexOf(1, from, p.whiteKing, p.pawn));
+            }
+            return;
+        }
+        for (int i = 0; i < kingMovesCount_[p.whiteKing]; ++i) {
+            Square from = kingMoves_[p.whiteKing][i];
+            if (from != p.pawn) fn(indexOf(0, p.blackKing, from, p.pawn));
+        }
+        if (getRank(p.pawn) >= 2) {
+            Square from = static_cast<Square>(p.pawn - 8);
+            if (from != p.whiteKing && from != p.blackKing) {
+                fn(indexOf(0, p.blackKing, p.whiteKing, from));
+            }
+        }
+        if (getRank(p.pawn) == 3) {
+            Square passed = static_cast<Square>(p.pawn - 8);
+            Square from = static_cast<Square>(p.pawn - 16);
+            if (passed != p.whiteKing && passed != p.blackKing && from != p.whiteKing && from != p.blackKing) {
+                fn(indexOf(0, p.blackKing, p.whiteKing, from));
+            }
+        }
+    }
+};
+
+struct KpkBitbase {
+    std::vector<uint64_t> bits;
+    double generationMs = 0.0;
+
+    KpkBitbase() {
+        auto start = std::chrono::steady_clock::now();
+        bits = KpkBuilder().build();
+        generationMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    bool wins(int idx) const {
+        return (bits[idx / 64] >> (idx % 64)) & 1;
+    }
+};
+
+const KpkBitbase KPK;
+
+} // namespace
+
+bool probeKPK(Color strong, Square strongKing, Square pawn, Square weakKing, Color sideToMove) {
+    // К виду базы: у белых пешка (иначе отражение по горизонтали), пешка на
+    // вертикалях a-d (иначе отражение по вертикали)
+    if (strong == Color::Black) {
+        strongKing ^= 56;
+        pawn ^= 56;
+        weakKing ^= 56;
+    }
+    if (getFile(pawn) >= 4) {
+        strongKing ^= 7;
+        pawn ^= 7;
+        weakKing ^= 7;
+    }
+    return KPK.wins(indexOf(sideToMove == strong ? 0 : 1, weakKing, strongKing, pawn));
+}
+
+bool isKPK(const Board& board, Color& strong) {
+    for (Color color : {Color::White, Color::Black}) {
+        if (board.materialKey() == Board::materialUnit(color, PieceType::Pawn)) {
+            strong = color;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool probeKPK(const Board& board, Color strong) {
+    Color weak = oppositeColor(strong);
+    return probeKPK(strong, Bitboards::lsb(board.pieces(strong, PieceType::King)),
+                    Bitboards::lsb(board.pieces(strong, PieceType::Pawn)),
+                    Bitboards::lsb(board.pieces(weak, PieceType::King)), board.position().sideToMove());
+}
+
+size_t kpkSizeBytes() {
+    return KPK.bits.size() * sizeof(uint64_t);
+}
+
+double kpkGenerationMs() {
+    return KPK.generationMs;
+}
+
+}}} // namespace Chess::AI::Bitbases
@@ -0,0 +1,313 @@
+#include "ai/Endgame.h"
+#include "ai/Bitbase.h"
+#include "ai/EvalParams.h"
+#include "core/Bitboards.h"
+#include <algorithm>
+#include <cstdlib>
+#include <unordered_map>
+
+namespace Chess {
+namespace AI {
+namespace Endgames {
+
+namespace {
+
+using namespace Bitboards;
+
+const EvalParams& params = DEFAULT_EVAL_PARAMS;
+
+int value(PieceType type) {
+    return params.material[static_cast<int>(type) - 1].eg;
+}
+
+int count(const Board& board, Color color, PieceType type) {
+    return popCount(board.pieces(color, type));
+}
+
+// Материал без пешек (эндшпильные веса)
+int nonPawnMaterial(const Board& board, Color color) {
+    int total = 0;
+    for (PieceType type : {PieceType::Knight, PieceType::Bishop, PieceType::Rook, PieceType::Queen}) {
+        total += count(board, color, type) * value(type);
+    }
+    return total;
+}
+
+Square kingOf(const Board& board, Color color) {
+    return lsb(board.pieces(color, PieceType::King));
+}
+
+int distance(Square a, Square b) {
+    return std::max(std::abs(getFile(a) - getFile(b)), std::abs(getRank(a) - getRank(b)));
+}
+
+// Темные поля (a1 - темное)
+constexpr Bitboard DARK_SQUARES = 0xAA55AA55AA55AA55ULL;
+
+bool isDarkSquare(Square sq) {
+    return (getFile(sq) + getRank(sq)) % 2 == 0;
+}
+
+// Король соперника у края и в углу: 0 в центре, 120 в углу
+int pushToEdge(Square sq) {
+    int file = getFile(sq);
+    int rank = getRank(sq);
+    return 20 * (std::max(3 - file, file - 4) + std::max(3 - rank, rank - 4));
+}
+
+// Короли рядом: 20 на расстоянии 7, 140 вплотную
+int pushClose(Square a, Square b) {
+    return 20 * (8 - distance(a, b));
+}
+
+// Фигура подальше от своего короля
+int pushAway(Square a, Square b) {
+    return 15 * (distance(a, b) - 1);
+}
+
+// Угол цвета слона: мат слоном и конем ставится только там. Мера - удаление
+// от диагонали, соединяющей два других угла (a1-h8 для светлых углов a8 и h1):
+// растет к нужным углам с любой клетки, в отличие от расстояния до угла.
+int pushToBishopCorner(Square sq, bool darkBishop) {
+    int file = getFile(sq);
+    int rank = getRank(sq);
+    int away = darkBishop ? std::abs(7 - file - rank) : std::abs(file - rank);
+    return 60 * away + pushToEdge(sq);
+}
+
+// Клетка со стороны strong: сильная сторона всегда "белые", идет вверх
+Square relative(Square sq, Color strong) {
+    return (strong == Color::White) ? sq : static_cast<Square>(sq ^ 56);
+}
+
+// Мат голому королю ставится ферзем, ладьей, двумя слонами разного цвета или
+// слоном с конем
+bool canForceMate(const Board& board, Color strong) {
+    Bitboard bishops = board.pieces(strong, PieceType::Bishop);
+    return board.pieces(strong, PieceType::Queen) || board.pieces(strong, PieceType::Rook) ||
+           (bishops && board.pieces(strong, PieceType::Knight)) ||
+           ((bishops & DARK_SQUARES) && (bishops & ~DARK_SQUARES));
+}
+
+// KXK: у соперника голый король. Выигрыш - гнать его к краю и подводить своего.
+int evaluateKXK(const Board& board, Color strong) {
+    Color weak = oppositeColor(strong);
+    Square weakKing = kingOf(board, weak);
+    int result = nonPawnMaterial(board, strong) +
+                 count(board, strong, PieceType::Pawn) * value(PieceType::Pawn) +
+                 pushToEdge(weakKing) + pushClose(kingOf(board, strong), weakKing);
+    return SCORE_KNOWN_WIN + result;
+}
+
+// KBNK: то же, но к углу цвета слона
+int evaluateKBNK(const Board& board, Color strong) {
+    Color weak = oppositeColor(strong);
+    Square weakKing = kingOf(board, weak);
+    bool darkBishop = isDarkSquare(lsb(board.pieces(strong, PieceType::Bishop)));
+    int result = value(PieceType::Bishop) + value(PieceType::Knight) +
+                 pushToBishopCorner(weakKing, darkBishop) + pushClose(kingOf(board, strong), weakKing);
+    return SCORE_KNOWN_WIN + result;
+}
+
+// KPK: исход точно по битовой базе. Ничья - 0; в выигрыше прогресс - пешка
+// ближе к превращению.
+int evaluateKPK(const Board& board, Color strong) {
+    if (!Bitbases::probeKPK(board, strong)) {
+        return 0;
+    }
+    Square pawn = relative(lsb(board.pieces(strong, PieceType::Pawn)), strong);
+    return SCORE_KNOWN_WIN + value(PieceType::Pawn) + 10 * getRank(pawn);
+}
+
+// KRKP: ладья против пешки. Выигрыш, если свой король перед пешкой или
+// король соперника от пешки далеко; ничейно, если пешку поддерживает
+// король у поля превращения, а наш король далеко.
+int evaluateKRKP(const Board& board, Color strong) {
+    Color weak = oppositeColor(strong);
+    Square strongKing = relative(kingOf(board, strong), strong);
+    Square weakKing = relative(kingOf(board, weak), strong);
+    Square rook = relative(lsb(board.pieces(strong, PieceType::Rook)), strong);
+    Square pawn = relative(lsb(board.pieces(weak, PieceType::Pawn)), strong);
+    Square queening = makeSquare(getFile(pawn), 0);
+    Square ahead = static_cast<Square>(pawn - 8);
+    int weakToMove = (board.position().sideToMove() == weak) ? 1 : 0;
+    int strongToMove = 1 - weakToMove;
+
+    if (getFile(strongKing) == getFile(pawn) && getRank(strongKing) < getRank(pawn)) {
+        return value(PieceType::Rook) - distance(strongKing, pawn);
+    }
+    if (distance(weakKing, pawn) >= 3 + weakToMove && distance(weakKing, rook) >= 3) {
+        return value(PieceType::Rook) - distance(strongKing, pawn);
+    }
+    if (getRank(weakKing) <= 2 && distance(weakKing, pawn) == 1 && getRank(strongKing) >= 3 &&
+        distance(strongKing, pawn) > 2 + strongToMove) {
+        return 40 - 4 * distance(strongKing, pawn);
+    }
+    return 100 - 4 * (distance(strongKing, ahead) - distance(weakKing, ahead) - distance(pawn, queening));
+}
+
+// KRKB, KRKN: в общем случае ничья; шансы - только у края доски
+int evaluateKRKB(const Board& board, Color strong) {
+    return pushToEdge(kingOf(board, oppositeColor(strong)));
+}
+
+int evaluateKRKN(const Board& board, Color strong) {
+    Color weak = oppositeColor(strong);
+    Square weakKing = kingOf(board, weak);
+    return pushToEdge(weakKing) + pushAway(weakKing, lsb(board.pieces(weak, PieceType::Knight)));
+}
+
+// KQKR: выигрыш, но долгий - гнать короля к краю
+int evaluateKQKR(const Board& board, Color strong) {
+    Color weak = oppositeColor(strong);
+    Square weakKing = kingOf(board, weak);
+    return value(PieceType::Queen) - value(PieceType::Rook) +
+           pushToEdge(weakKing) + pushClose(kingOf(board, strong), weakKing);
+}
+
+// KNNK: мат не форсируется
+int evaluateDraw(const Board&, Color) {
+    return 0;
+}
+
+// Разноцветные слоны: даже с лишними пешками - почти ничья. С ладьями на
+// доске ничейность слабее.
+bool oppositeBishops(const Board& board) {
+    Bitboard white = board.pieces(Color::White, PieceType::Bishop);
+    Bitboard black = board.pieces(Color::Black, PieceType::Bishop);
+    return isDarkSquare(lsb(white)) != isDarkSquare(lsb(black));
+}
+
+int scaleOppositeBishops(const Board& board, Color) {
+    return oppositeBishops(board) ? 20 : SCALE_NORMAL;
+}
+
+int scaleOppositeBishopsWithRooks(const Board& board, Color) {
+    return oppositeBishops(board) ? 46 : SCALE_NORMAL;
+}
+
+// Без пешек лишней легкой фигуры для выигрыша мало
+int scaleNoPawns(const Board& board, Color strong) {
+    if (board.pieces(strong, PieceType::Pawn)) {
+        return SCALE_NORMAL;
+    }
+    Color weak = oppositeColor(strong);
+    int strongMaterial = nonPawnMaterial(board, strong);
+    int weakMaterial = nonPawnMaterial(board, weak);
+    if (strongMaterial - weakMaterial > value(PieceType::Bishop)) {
+        return SCALE_NORMAL;
+    }
+    if (strongMaterial < value(PieceType::Rook)) {
+        return 0;
+    }
+    return weakMaterial <= value(PieceType::Bishop) ? 4 : 14;
+}
+
+// Реестр: сигнатура -> оценка (точный материал) или масштаб (материал без пешек)
+class Registry {
+public:
+    Registry() {
+        addEvaluation("KBNK", evaluateKBNK);
+        addEvaluation("KNNK", evaluateDraw);
+        addEvaluation("KPK", evaluateKPK);
+        addEvaluation("KRKP", evaluateKRKP);
+        addEvaluation("KRKB", evaluateKRKB);
+        addEvaluation("KRKN", evaluateKRKN);
+        addEvaluation("KQKR", evaluateKQKR);
+
+        addScaling("KBKB", scaleOppositeBishops);
+        addScaling("KRBKRB", scaleOppositeBishopsWithRooks);
+    }
+
+    const Entry* findEvaluation(const Board& board) const {
+        if (popCount(board.occupied()) > maxEvaluationPieces_) return nullptr;
+        auto it = evaluations_.find(board.materialKey());
+        return it != evaluations_.end() ? &it->second : nullptr;
+    }
+
+    const Entry* findScaling(const Board& board) const {
+        Bitboard pawns = board.pieces(Color::White, PieceType::Pawn) | board.pieces(Color::Black, PieceType::Pawn);
+        if (popCount(board.occupied() & ~pawns) > maxScalingPieces_) return nullptr;
+        auto it = scalings_.find(board.materialKey() & ~Board::PAWN_COUNT_MASK);
+        return it != scalings_.end() ? &it->second : nullptr;
+    }
+
+private:
+    std::unordered_map<uint64_t, Entry> evaluations_;
+    std::unordered_map<uint64_t, Entry> scalings_;
+    int maxEvaluationPieces_ = 0;   // Фильтр: больше фигур на доске - точно не эндшпиль реестра
+    int maxScalingPieces_ = 0;
+
+    static int pieceCount(const char* code) {
+        return static_cast<int>(std::char_traits<char>::length(code));
+    }
+
+    void addEvaluation(const char* code, EvaluateFn evaluate) {
+        for (Color strong : {Color::White, Color::Black}) {
+            Entry entry;
+            entry.evaluate = evaluate;
+            entry.strong = strong;
+            evaluations_[materialKeyOf(code, strong)] = entry;
+        }
+        maxEvaluationPieces_ = std::max(maxEvaluationPieces_, pieceCount(code));
+    }
+
+    void addScaling(const char* code, ScaleFn scale) {
+        for (Color strong : {Color::White, Color::Black}) {
+            Entry entry;
+            entry.scale = scale;
+            scalings_[materialKeyOf(code, strong)] = entry;
+        }
+        maxScalingPieces_ = std::max(maxScalingPieces_, pieceCount(code));
+    }
+};
+
+const Registry REGISTRY;
+
+const Entry KXK[2] = {
+    {evaluateKXK, nullptr, Color::White},
+    {evaluateKXK, nullptr, Color::Black},
+};
+const Entry NO_PAWNS = {nullptr, scaleNoPawns, Color::White};
+
+} // namespace
+
+uint64_t materialKeyOf(const char* code, Color strong) {
+    uint64_t key = 0;
+    Color color = oppositeColor(strong);
+    for (const char* c = code; *c; ++c) {
+        PieceType type = PieceType::None;
+        switch (*c) {
+            case 'K': color = oppositeColor(color); continue;    // Король открывает сторону
+            case 'P': type = PieceType::Pawn; break;
+            case 'N': type = PieceType::Knight; break;
+            case 'B': type = PieceType::Bishop; break;
+            case 'R': type = PieceType::Rook; break;
+            case 'Q': type = PieceType::Queen; break;
+            default: continue;
+        }
+        key += Board::materialUnit(color, type);
+    }
+    return key;
+}
+
+const Entry* probe(const Board& board) {
+    if (const Entry* entry = REGISTRY.findEvaluation(board)) {
+        return entry;
+    }
+    for (Color strong : {Color::White, Color::Black}) {
+        Color weak = oppositeColor(strong);
+        if (board.occupied(weak) == board.pieces(weak, PieceType::King) && canForceMate(board, strong)) {
+            return &KXK[static_cast<int>(strong)];
+        }
+    }
+    if (const Entry* entry = REGISTRY.findScaling(board)) {
+        return entry;
+    }
+    if (!board.pieces(Color::White, PieceType::Pawn) || !board.pieces(Color::Black, PieceType::Pawn)) {
+        return &NO_PAWNS;
+    }
+    return nullptr;
+}
+
+}}} // namespace Chess::AI::Endgames
@@ -1,141 +1,413 @@
 #include "ai/Engine.h"
+#include "ai/Bitbase.h"
+#include "ai/Endgame.h"
+#include "ai/ThreadPlacement.h"
 #include "ai/Evaluator.h"
+#include "ai/Nnue.h"
 #include "core/MoveGenerator.h"
 #include <algorithm>
 #include <chrono>
-#include <limits>
 #include <sstream>
 #include <iomanip>
 #include <ctime>
 #include <cstdlib>
+#include <cmath>
 
 namespace Chess {
 namespace AI {
 
+namespace {
+
+// Приоритеты упорядочивания: ход из таблицы транспозиций > взятия >
+// превращения > киллеры > контрход > history
+constexpr int TT_MOVE_SCORE = 2000000;
+constexpr int CAPTURE_SCORE = 1000000;
+constexpr int PROMOTION_SCORE = 900000;
+constexpr int KILLER_1_SCORE = 800000;
+constexpr int KILLER_2_SCORE = 790000;
+constexpr int COUNTER_MOVE_SCORE = 780000;
+
+// Null-move pruning: минимальная глубина, с которой пробуем нулевой ход,
+// и глубина, начиная с которой отсечение подтверждается поиском без него
+constexpr int NULL_MOVE_MIN_DEPTH = 3;
+constexpr int NULL_MOVE_VERIFY_DEPTH = 6;
+
+// Размер таблицы транспозиций по умолчанию
+constexpr size_t DEFAULT_HASH_MB = 16;
+
+std::string pvToString(const std::vector<Move>& pv) {
+    std::string result;
+    for (const Move& move : pv) {
+        if (!result.empty()) result += ' ';
+        result += move.toAlgebraic();
+    }
+    return result;
+}
+
+} // namespace
+
 Engine::Engine(Board& board) 
-    : board_(board), maxDepth_(5), shouldStop_(false), logFilename_("chess_ai.log") {}
+    : Engine(board, std::make_shared<TranspositionTable>(DEFAULT_HASH_MB)) {}
+
+Engine::Engine(Board& board, std::shared_ptr<TranspositionTable> table,
+               std::shared_ptr<EvalCache> evalCache)
+    : board_(board), maxDepth_(5), shouldStop_(false), logFilename_("chess_ai.log"),
+      tt_(std::move(table)),
+      evalCache_(evalCache ? std::move(evalCache) : std::make_shared<EvalCache>()) {
+    resetHeuristics();
+    initLmrTable();
+}
+
+void Engine::setHashSize(size_t sizeMb) {
+    tt_->resize(sizeMb);
+}
+
+void Engine::clearHash() {
+    tt_->clear();
+    evalCache_->clear();
+    pawnTable_.clear();
+    for (auto& worker : rootWorkers_) {
+        worker->engine->pawnTable_.clear();
+    }
+}
+
+void Engine::setNnue(std::shared_ptr<const Nnue::Network> network) {
+    accumulator_.reset();
+    nnue_ = std::move(network);
+    if (nnue_) {
+        accumulator_ = std::make_unique<Nnue::Accumulator>(nnue_);
+        accumulator_->attach(board_);
+    }
+    // Оценки другого оценщика в кеше не годятся (у потоков кеш общий с родителем)
+    if (!parent_) {
+        evalCache_->clear();
+    }
+}
+
+void Engine::setEvalCacheSize(size_t sizeMb) {
+    evalCache_->resize(sizeMb);
+}
+
+void Engine::setSearchParams(const SearchParams& params) {
+    params_ = params;
+    initLmrTable();
+}
+
+void Engine::initLmrTable() {
+    for (int depth = 0; depth < LMR_TABLE_SIZE; ++depth) {
+        for (int moveIndex = 0; moveIndex < LMR_TABLE_SIZE; ++moveIndex) {
+            if (depth == 0 || moveIndex == 0) {
+                lmrTable_[depth][moveIndex] = 0;
+                continue;
+            }
+            double reduction = params_.lmrBase +
+                std::log(depth) * std::log(moveIndex) / params_.lmrDivisor;
+            lmrTable_[depth][moveIndex] = std::max(0, static_cast<int>(reduction));
+        }
+    }
+}
+
+Engine::~Engine() {
+    stopAnalysis();
+}
+
+int Engine::lmrReduction(int depth, int moveIndex) const {
+    return lmrTable_[std::min(depth, LMR_TABLE_SIZE - 1)][std::min(moveIndex, LMR_TABLE_SIZE - 1)];
+}
+
+void Engine::prepareSearch() {
+    shouldStop_ = false;
+    setDeadline(std::chrono::steady_clock::time_point());
+    nodeLimit_ = 0;
+    liveNodes_ = 0;
+    timeCheckCounter_ = 0;
+    
+    // Детерминированный режим: результат не зависит от предыдущих поисков
+    if (deterministic_) {
+        tt_->clear();
+        evalCache_->clear();    // Ключ в кеше неполный - исключаем даже коллизии
+        resetHeuristics();
+        lastPv_.clear();
+        lastPvHash_ = 0;
+    }
+}
 
 SearchResult Engine::findBestMove(Color color, int maxDepth) {
+    prepareSearch();
+    ageHistory();
+    tt_->newSearch();
+    return searchRoot(color, maxDepth);
+}
+
+std::vector<SearchResult> Engine::findBestMoves(Color color, int numLines, int maxDepth) {
+    prepareSearch();
+    ageHistory();
+    tt_->newSearch();
+    
+    std::vector<SearchResult> lines;
+    for (int depth = 1; depth <= maxDepth; ++depth) {
+        std::vector<SearchResult> current;
+        std::vector<Move> excluded;
+        
+        for (int line = 0; line < numLines; ++line) {
+            // Первым в линии пробуем ход, занявший это место на прошлой итерации
+            if (line < static_cast<int>(lines.size())) {
+                lastPv_ = lines[line].pv;
+                lastPvHash_ = board_.hash();
+            }
+            
+            SearchResult result = searchRoot(color, depth, excluded);
+            if (!result.bestMove.isValid() || stopRequested()) {
+                break;  // Легальные ходы кончились или поиск остановлен
+            }
+            excluded.push_back(result.bestMove);
+            current.push_back(result);
+        }
+        
+        // Прерванная итерация неполна - остаются линии предыдущей
+        if (stopRequested() && depth > 1) {
+            break;
+        }
+        lines = current;
+        log("MultiPV: глубина " + std::to_string(depth) + ", линий " + std::to_string(lines.size()));
+    }
+    
+    maxDepth_ = maxDepth;
+    return lines;
+}
+
+SearchResult Engine::searchRoot(Color color, int maxDepth, const std::vector<Move>& excludedMoves) {
     maxDepth_ = maxDepth;
-    shouldStop_ = false;
     
     auto startTime = std::chrono::high_resolution_clock::now();
     
     MoveGenerator generator(board_);
     std::vector<Move> moves = generator.generateLegalMoves(color);
     
+    // MultiPV: ходы предыдущих линий не рассматриваем
+    moves.erase(std::remove_if(moves.begin(), moves.end(), [&excludedMoves](const Move& move) {
+        return std::find(excludedMoves.begin(), excludedMoves.end(), move) != excludedMoves.end();
+    }), moves.end());
+    
     if (moves.empty()) {
-        return SearchResult{Move(), 0, 0, 0, 0.0};
+        return SearchResult{Move(), 0, 0, 0, 0.0, SearchStats(), {}, 0, 0, 0};
     }
     
-    // Упорядочить ходы
+    // Упорядочить ходы, лучший ход прошлой итерации - первым
     orderMoves(moves, color);
+    if (!lastPv_.empty() && lastPvHash_ == board_.hash()) {
+        auto it = std::find(moves.begin(), moves.end(), lastPv_[0]);
+        if (it != moves.end()) {
+            std::rotate(moves.begin(), it, it + 1);
+        }
+    }
     
     logSearchStart(color, maxDepth_, 0);
     
     Move bestMove = moves[0];
-    int bestScore = std::numeric_limits<int>::min();
+    int bestScore = -SCORE_INFINITY;
+    std::vector<Move> bestPv{moves[0]};
     std::atomic<int> nodesSearched(0);
+    std::atomic<int> quiescenceNodes(0);
+    std::atomic<int> selDepth(0);
+    stats_ = SearchStats();
+    std::mutex statsMutex;
     
     // Используем многопоточность только на первом уровне и если ходов достаточно
-    bool useParallel = (moves.size() >= 4 && maxDepth_ >= 3);
+    // (в детерминированном режиме - никогда: результат зависел бы от планировщика)
+    bool useParallel = (parallelRoot_ && !deterministic_ && moves.size() >= 4 && maxDepth_ >= 3);
     
     if (useParallel) {
         // Многопоточный поиск - используем FEN для создания копий доски
         std::string fenBefore = board_.toFEN();
         int searchDepth = maxDepth_;  // Сохраняем в локальную переменную
-        std::vector<std::future<std::pair<Move, int>>> futures;
+        std::vector<std::future<RootMoveResult>> futures;
+        
+        // Лучшая точная оценка среди уже досчитанных ходов - нижняя граница
+        // для нулевого окна PVS в остальных потоках
+        std::atomic<int> sharedAlpha(-SCORE_INFINITY);
         
         log("Используется многопоточный поиск (" + std::to_string(moves.size()) + " ходов)");
         
+        // Движки потоков создаются один раз, до запуска: потоки только берут свой слот
+        while (rootWorkers_.size() < moves.size()) {
+            auto worker = std::make_unique<RootWorker>();
+            worker->engine = std::make_unique<Engine>(worker->board, tt_, evalCache_);
+            worker->engine->parent_ = this;  // stop() и лимит времени - общие
+            worker->engine->setLogFile("");  // Отключаем логирование в потоках
+            rootWorkers_.push_back(std::move(worker));
+        }
+        
         for (const Move& move : moves) {
-            if (shouldStop_) break;
+            if (stopRequested()) break;
             
-            futures.push_back(std::async(std::launch::async, [move, searchDepth, color, fenBefore, &nodesSearched]() {
-                // Создаем копию доски через FEN
-                Board boardCopy;
+            int threadIndex = static_cast<int>(futures.size());
+            futures.push_back(std::async(std::launch::async, [this, move, searchDepth, color, fenBefore,
+                                                              threadIndex,
+                                                              &nodesSearched, &quiescenceNodes, &selDepth,
+                                                              &sharedAlpha, &statsMutex]() {
+                int cpu = pinCurrentThread(threadIndex);
+
+                // Доска слота - копия через FEN
+                RootWorker& worker = *rootWorkers_[threadIndex];
+                Board& boardCopy = worker.board;
+                Engine& threadEngine = *worker.engine;
                 boardCopy.setFromFEN(fenBefore);
-                Engine threadEngine(boardCopy);
+                boardCopy.clearHistory();  // Ход корня прошлой итерации
                 threadEngine.setDifficulty(searchDepth);
-                threadEngine.setLogFile("");  // Отключаем логирование в потоках
+                threadEngine.setSearchParams(params_);
+                if (threadEngine.nnue_ != nnue_) {
+                    threadEngine.setNnue(nnue_);
+                }
+                // Эвристики - с чистого листа, history главного движка - стартовая точка для потока
+                threadEngine.resetHeuristics();
+                threadEngine.stats_ = SearchStats();
+                threadEngine.quiescenceNodes_ = 0;
+                threadEngine.selDepth_ = 0;
+                std::copy(&history_[0][0][0], &history_[0][0][0] + 2 * NUM_SQUARES * NUM_SQUARES,
+                          &threadEngine.history_[0][0][0]);
                 
                 boardCopy.makeMove(move);
+                threadEngine.moveStack_[0] = move;
                 int localNodes = 0;
-                int score = -threadEngine.alphaBeta(searchDepth - 1, 
-                                                    std::numeric_limits<int>::min(), 
-                                                    std::numeric_limits<int>::max(), 
-                                                    oppositeColor(color), 
-                                                    localNodes);
+                
+                RootMoveResult result{move, 0, true, {}, cpu};
+                int alpha = sharedAlpha.load();
+                if (alpha > -SCORE_INFINITY) {
+                    // PVS: сначала проверяем, может ли ход быть лучше уже найденного
+                    result.score = -threadEngine.alphaBeta(searchDepth - 1, -alpha - 1, -alpha,
+                                                           oppositeColor(color), localNodes, 1);
+                    result.exact = false;
+                }
+                if (result.exact || result.score > alpha) {
+                    if (!result.exact) {
+                        threadEngine.stats_.pvsReSearches++;
+                    }
+                    result.score = -threadEngine.alphaBeta(searchDepth - 1, 
+                                                           -SCORE_INFINITY, 
+                                                           SCORE_INFINITY, 
+                                                           oppositeColor(color), 
+                                                           localNodes, 1);
+                    result.exact = true;
+                    
+                    int current = sharedAlpha.load();
+                    while (result.score > current &&
+                           !sharedAlpha.compare_exchange_weak(current, result.score)) {
+                    }
+                }
+                result.pv = threadEngine.extractPv(1);
+                result.pv.insert(result.pv.begin(), move);
+                threadEngine.flushNodeCount();
+                
                 nodesSearched += localNodes;
-                return std::make_pair(move, score);
+                quiescenceNodes += threadEngine.quiescenceNodes_;
+                int threadSelDepth = threadEngine.selDepth_;
+                int currentSelDepth = selDepth.load();
+                while (threadSelDepth > currentSelDepth &&
+                       !selDepth.compare_exchange_weak(currentSelDepth, threadSelDepth)) {
+                }
+                {
+                    std::lock_guard<std::mutex> lock(statsMutex);
+                    stats_.merge(threadEngine.stats_);
+                }
+                return result;
             }));
+            
+            // Первый (главный) ход досчитываем до запуска остальных, чтобы они
+            // сразу получили границу alpha (Young Brothers Wait)
+            if (futures.size() == 1) {
+                futures[0].wait();
+            }
         }
         
         // Собираем результаты
         for (size_t i = 0; i < futures.size(); ++i) {
-            if (shouldStop_) break;
+            if (stopRequested()) break;
             
-            auto result = futures[i].get();
-            int score = result.second;
+            RootMoveResult result = futures[i].get();
             
-            logMoveEvaluation(result.first, score, maxDepth_, nodesSearched.load());
+            logMoveEvaluation(result.move, result.score, maxDepth_, nodesSearched.load());
+            if (result.cpu >= 0) {
+                log("    поток " + std::to_string(i) + ": CPU " + std::to_string(result.cpu) +
+                    ", NUMA-узел " + std::to_string(cpuTopology().nodeOfCpu(result.cpu)));
+            }
             
-            if (score > bestScore) {
-                bestScore = score;
-                bestMove = result.first;
+            // Оценка из нулевого окна - лишь верхняя граница, выбирать по ней нельзя
+            if (result.exact && result.score > bestScore) {
+                bestScore = result.score;
+                bestMove = result.move;
+                bestPv = result.pv;
                 
                 if (progressCallback_) {
-                    progressCallback_(maxDepth_, score, result.first);
+                    progressCallback_(maxDepth_, result.score, result.move);
                 }
             }
         }
     } else {
-        // Однопоточный поиск
-        std::string currentFen = board_.toFEN();
+        // Однопоточный поиск. Первый ход - с полным окном, остальные (PVS) -
+        // нулевым окном на уровне лучшего и полным пересмотром, если ход лучше.
+        // Штраф за повторение зависит только от позиции после хода, поэтому
+        // он известен до поиска и сдвигает окно хода.
+        quiescenceNodes_ = 0;
+        selDepth_ = 0;
         for (const Move& move : moves) {
-            if (shouldStop_) break;
+            if (stopRequested()) break;
             
             board_.makeMove(move);
+            moveStack_[0] = move;
             int localNodes = 0;
-            int score = -alphaBeta(maxDepth_ - 1, 
-                                   std::numeric_limits<int>::min(), 
-                                   std::numeric_limits<int>::max(), 
+            int repetitionPenalty = checkPositionRepetition();
+            
+            int score;
+            bool fullWindow = bestScore == -SCORE_INFINITY;
+            if (!fullWindow) {
+                int alpha = bestScore + repetitionPenalty;
+                score = -alphaBeta(maxDepth_ - 1, -alpha - 1, -alpha, oppositeColor(color), localNodes, 1);
+                if (score > alpha && !stopRequested()) {
+                    stats_.pvsReSearches++;
+                    fullWindow = true;
+                }
+            }
+            if (fullWindow) {
+                score = -alphaBeta(maxDepth_ - 1, 
+                                   -SCORE_INFINITY, 
+                                   SCORE_INFINITY, 
                                    oppositeColor(color), 
-                                   localNodes);
+                                   localNodes, 1);
+            }
             nodesSearched += localNodes;
             
-            // Проверяем повторение позиции и применяем штраф
-            std::string fenAfter = board_.toFEN();
-            int repetitionPenalty = checkPositionRepetition(fenAfter);
             if (repetitionPenalty > 0) {
                 score -= repetitionPenalty;
                 log("  Штраф за повторение позиции: -" + std::to_string(repetitionPenalty));
             }
             
-            // Оценка эндшпиля - если у противника только король, приближаемся к нему
-            int endgameBonus = evaluateEndgameMate(board_, color);
-            if (endgameBonus != 0) {
-                score += endgameBonus;
-                log("  Бонус за эндшпиль: +" + std::to_string(endgameBonus));
-            }
-            
             board_.unmakeMove(move);
             
-            if (shouldStop_) break;
+            if (stopRequested()) break;
             
             logMoveEvaluation(move, score, maxDepth_, nodesSearched.load());
             
-            if (score > bestScore) {
+            // Без пересмотра оценка - лишь верхняя граница, не выше лучшей
+            if (fullWindow && score > bestScore) {
                 bestScore = score;
                 bestMove = move;
+                bestPv = extractPv(1);
+                bestPv.insert(bestPv.begin(), move);
                 
                 if (progressCallback_) {
                     progressCallback_(maxDepth_, score, move);
                 }
             }
         }
+        quiescenceNodes = quiescenceNodes_;
+        selDepth = selDepth_;
+        flushNodeCount();
     }
     
+    lastPv_ = bestPv;
+    lastPvHash_ = board_.hash();
+    
     auto endTime = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
     
@@ -144,7 +416,12 @@ SearchResult Engine::findBestMove(Color color, int maxDepth) {
         bestScore,
         maxDepth_,
         nodesSearched.load(),
-        duration.count() / 1000.0
+        duration.count() / 1000.0,
+        stats_,
+        bestPv,
+        selDepth.load(),
+        nodesSearched.load() - quiescenceNodes.load(),
+        quiescenceNodes.load()
     };
     
     logSearchResult(result);
@@ -153,66 +430,341 @@ SearchResult Engine::findBestMove(Color color, int maxDepth) {
 }
 
 SearchResult Engine::findBestMoveWithTimeLimit(Color color, int timeMs) {
-    // Начинаем с глубины 1 и увеличиваем (iterative deepening)
-    SearchResult lastResult;
-    shouldStop_ = false;
+    prepareSearch();
     
     log("=== Начало поиска с ограничением по времени ===");
     logSearchStart(color, maxDepth_, timeMs);
     
-    auto startTime = std::chrono::high_resolution_clock::now();
-    auto deadline = startTime + std::chrono::milliseconds(timeMs);
+    searchStart_ = std::chrono::steady_clock::now();
+    setDeadline(searchStart_ + std::chrono::milliseconds(timeMs));
+    
+    SearchResult result = iterativeDeepening(color, maxDepth_);
+    
+    setDeadline(std::chrono::steady_clock::time_point());
+    shouldStop_ = false;
+    log("=== Конец поиска ===");
+    return result;
+}
+
+SearchResult Engine::findBestMoveWithNodeLimit(Color color, uint64_t maxNodes) {
+    prepareSearch();
+    
+    log("=== Начало поиска с ограничением по узлам: " + std::to_string(maxNodes) + " ===");
+    logSearchStart(color, maxDepth_, 0);
+    
+    searchStart_ = std::chrono::steady_clock::now();
+    nodeLimit_ = maxNodes;
+    
+    SearchResult result = iterativeDeepening(color, maxDepth_);
+    
+    nodeLimit_ = 0;
+    shouldStop_ = false;
+    log("=== Конец поиска ===");
+    return result;
+}
+
+std::future<SearchResult> Engine::startPondering(Color color, int timeMs) {
+    // Флаги сбрасываются здесь, а не в фоновом потоке: stop() или ponderHit(),
+    // вызванные сразу после запуска, не должны потеряться
+    prepareSearch();
+    ponderTimeMs_ = timeMs;
+    searchStart_ = std::chrono::steady_clock::now();
+    
+    log("=== Пондеринг: поиск на время соперника ===");
+    logSearchStart(color, maxDepth_, 0);
+    
+    return std::async(std::launch::async, [this, color]() {
+        SearchResult result = iterativeDeepening(color, maxDepth_);
+        log("=== Конец пондеринга ===");
+        return result;
+    });
+}
+
+void Engine::ponderHit() {
+    // Часы идут с начала пондеринга: время соперника уже потрачено "бесплатно"
+    log("Ponderhit: соперник сделал ожидаемый ход");
+    setDeadline(searchStart_ + std::chrono::milliseconds(ponderTimeMs_));
+}
+
+void Engine::setDeadline(std::chrono::steady_clock::time_point deadline) {
+    deadlineNs_ = deadline.time_since_epoch().count() == 0 ? 0 :
+        std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count();
+}
+
+void Engine::flushNodeCount() {
+    Engine* root = parent_ ? parent_ : this;
+    root->liveNodes_.fetch_add(static_cast<uint64_t>(timeCheckCounter_), std::memory_order_relaxed);
+    timeCheckCounter_ = 0;
+}
+
+bool Engine::stopRequested() const {
+    return shouldStop_ || (parent_ && parent_->shouldStop_);
+}
+
+void Engine::pollDeadline() {
+    // Часы опрашиваем раз в TIME_CHECK_INTERVAL узлов - это дешевле, чем в каждом
+    if (++timeCheckCounter_ < TIME_CHECK_INTERVAL) {
+        return;
+    }
+    flushNodeCount();
+    Engine* root = parent_ ? parent_ : this;
+    uint64_t nodeLimit = root->nodeLimit_.load(std::memory_order_relaxed);
+    if (nodeLimit != 0 && root->liveNodes_.load(std::memory_order_relaxed) >= nodeLimit) {
+        root->shouldStop_ = true;
+    }
+    int64_t deadline = root->deadlineNs_.load(std::memory_order_relaxed);
+    if (deadline != 0) {
+        int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+        if (now >= deadline) {
+            root->shouldStop_ = true;
+        }
+    }
+}
+
+void Engine::startAnalysis(Color color, int intervalMs) {
+    stopAnalysis();
+    
+    if (!analysisChannel_) {
+        analysisChannel_ = std::make_unique<AnalysisChannel>();
+    }
+    AnalysisSnapshot stale;
+    while (analysisChannel_->tryPop(stale)) {
+    }
+    
+    prepareSearch();
+    searchStart_ = std::chrono::steady_clock::now();
+    analysisResult_ = SearchResult{Move(), 0, 0, 0, 0.0, SearchStats(), {}, 0, 0, 0};
+    analysisDone_ = false;
+    analysisActive_ = true;
+    
+    log("=== Бесконечный анализ ===");
+    logSearchStart(color, MAX_PLY - 1, 0);
+    
+    // Сложность движка после анализа должна остаться прежней
+    int savedDepth = maxDepth_;
+    analysisThread_ = std::thread([this, color, savedDepth]() {
+        iterativeDeepening(color, MAX_PLY - 1);
+        maxDepth_ = savedDepth;
+        {
+            std::lock_guard<std::mutex> lock(analysisMutex_);
+            analysisDone_ = true;
+        }
+        analysisCv_.notify_one();
+    });
+    
+    reporterThread_ = std::thread([this, intervalMs]() {
+        auto interval = std::chrono::milliseconds(std::max(intervalMs, 1));
+        std::unique_lock<std::mutex> lock(analysisMutex_);
+        while (!analysisCv_.wait_for(lock, interval, [this]() { return analysisDone_; })) {
+            lock.unlock();
+            publishSnapshot(false);
+            lock.lock();
+        }
+        lock.unlock();
+        publishSnapshot(true);
+    });
+}
+
+void Engine::stopAnalysis() {
+    if (!analysisThread_.joinable()) {
+        return;
+    }
+    shouldStop_ = true;
+    analysisThread_.join();
+    reporterThread_.join();
+    analysisActive_ = false;
+    log("=== Конец анализа ===");
+}
+
+bool Engine::pollAnalysis(AnalysisSnapshot& snapshot) {
+    return analysisChannel_ && analysisChannel_->tryPop(snapshot);
+}
+
+void Engine::publishSnapshot(bool finished) {
+    AnalysisSnapshot snapshot;
+    {
+        std::lock_guard<std::mutex> lock(analysisMutex_);
+        snapshot.depth = analysisResult_.depth;
+        snapshot.selDepth = analysisResult_.selDepth;
+        snapshot.score = analysisResult_.score;
+        snapshot.pv = analysisResult_.pv;
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - searchStart_).count();
+    snapshot.nodes = liveNodes_.load(std::memory_order_relaxed);
+    snapshot.nps = elapsed > 0 ? snapshot.nodes * 1000 / static_cast<uint64_t>(elapsed) : 0;
+    snapshot.hashfull = tt_->hashfull();
+    snapshot.elapsedMs = static_cast<int>(elapsed);
+    snapshot.finished = finished;
     
-    for (int depth = 1; depth <= maxDepth_; ++depth) {
-        auto currentTime = std::chrono::high_resolution_clock::now();
-        if (currentTime >= deadline) {
-            log("Время истекло, используем результат с глубины " + std::to_string(depth - 1));
+    // Читатель не успевает - снимок теряется, поиск не ждет
+    analysisChannel_->tryPush(std::move(snapshot));
+}
+
+SearchResult Engine::iterativeDeepening(Color color, int depthLimit) {
+    // Начинаем с глубины 1 и увеличиваем (iterative deepening)
+    SearchResult lastResult{Move(), 0, 0, 0, 0.0, SearchStats(), {}, 0, 0, 0};
+    
+    // Эвристики накапливаются между итерациями, стареют только между поисками
+    ageHistory();
+    tt_->newSearch();
+    
+    for (int depth = 1; depth <= depthLimit; ++depth) {
+        if (stopRequested()) {
+            log("Поиск остановлен, используем результат с глубины " + std::to_string(depth - 1));
             break;
         }
         
-        // Проверяем время во время поиска
-        int remainingTime = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - currentTime).count();
-        if (remainingTime < 100) {  // Если осталось меньше 100мс, не начинаем новую итерацию
-            log("Осталось мало времени (" + std::to_string(remainingTime) + "мс), используем предыдущий результат");
-            break;
+        // Глубина 1 считается всегда: без нее не будет хода вовсе
+        int64_t deadline = deadlineNs_.load();
+        if (deadline != 0 && depth > 1) {
+            int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+            int remainingTime = static_cast<int>((deadline - now) / 1000000);
+            if (remainingTime < 100) {  // Если осталось меньше 100мс, не начинаем новую итерацию
+                log("Осталось мало времени (" + std::to_string(remainingTime) + "мс), используем предыдущий результат");
+                break;
+            }
+            log("Поиск на глубине " + std::to_string(depth) + ", осталось времени: " + std::to_string(remainingTime) + "мс");
+        } else {
+            log("Поиск на глубине " + std::to_string(depth));
         }
         
-        log("Поиск на глубине " + std::to_string(depth) + ", осталось времени: " + std::to_string(remainingTime) + "мс");
-        lastResult = findBestMove(color, depth);
+        SearchResult result = searchRoot(color, depth);
         
-        // Проверяем, не вышли ли за время
-        currentTime = std::chrono::high_resolution_clock::now();
-        if (currentTime >= deadline) {
-            shouldStop_ = true;
+        // Прерванная итерация неполна - остается результат предыдущей
+        if (stopRequested() && depth > 1) {
             log("Время истекло во время поиска");
             break;
         }
+        lastResult = result;
+        
+        if (analysisActive_) {
+            std::lock_guard<std::mutex> lock(analysisMutex_);
+            analysisResult_ = lastResult;
+        }
+        
+        // Мат найден с точной длиной - более глубокий поиск его не изменит
+        int mateMoves = mateInMoves(lastResult.score);
+        if (mateMoves != 0 && std::abs(mateMoves) * 2 <= depth) {
+            log("Найден мат в " + std::to_string(mateMoves) + " ходов, поиск завершен");
+            break;
+        }
     }
     
-    shouldStop_ = false;
-    log("=== Конец поиска ===");
+    // searchRoot перезаписывает maxDepth_ глубиной итерации - восстанавливаем предел
+    maxDepth_ = depthLimit;
     return lastResult;
 }
 
-int Engine::alphaBeta(int depth, int alpha, int beta, Color color, int& nodesSearched) {
+int Engine::alphaBeta(int depth, int alpha, int beta, Color color, int& nodesSearched, int ply,
+                      bool allowNull) {
+    if (ply <= MAX_PLY) {
+        pvLength_[ply] = ply;
+    }
+    
+    bool inCheck = board_.isCheck(color);
+    
+    // Шах продлевает вариант на полуход: форсированные линии с шахами не
+    // обрываются горизонтом. Предел по ply не дает продлениям зациклиться.
+    if (inCheck && ply < 2 * maxDepth_) {
+        depth++;
+        stats_.checkExtensions++;
+    }
+    
+    if (depth <= 0 || ply >= MAX_PLY) {
+        return quiescence(alpha, beta, color, nodesSearched, ply, 0);
+    }
+    
     nodesSearched++;
+    selDepth_ = std::max(selDepth_, ply);
+    pollDeadline();
+    
+    if (stopRequested()) {
+        return 0;
+    }
     
-    if (shouldStop_) {
+    // Mate distance pruning: мат короче уже найденного отсюда не получить
+    alpha = std::max(alpha, matedIn(ply));
+    beta = std::min(beta, mateIn(ply + 1));
+    if (alpha >= beta) {
+        stats_.mateDistanceCutoffs++;
+        return alpha;
+    }
+    
+    // KPK: ничья по битовой базе точна - дальше искать нечего. Выигрыш
+    // ищется как обычно: оценка по базе ведет пешку к превращению.
+    Color kpkStrong;
+    if (ply > 0 && Bitbases::isKPK(board_, kpkStrong) && !Bitbases::probeKPK(board_, kpkStrong)) {
+        stats_.bitbaseDraws++;
         return 0;
     }
     
-    if (depth == 0) {
-        return quiescence(alpha, beta, color, nodesSearched, 0);
+    bool pvNode = beta - alpha > 1;
+    int originalAlpha = alpha;
+    
+    // Таблица транспозиций: в не-PV узлах достаточно глубокая запись отвечает сразу
+    TTEntry ttEntry;
+    Move ttMove;
+    if (tt_->probe(board_.hash(), ttEntry)) {
+        ttMove = ttEntry.move;
+        int ttScore = scoreFromTT(ttEntry.score, ply);
+        if (!pvNode && ttEntry.depth >= depth &&
+            (ttEntry.bound == Bound::Exact ||
+             (ttEntry.bound == Bound::Lower && ttScore >= beta) ||
+             (ttEntry.bound == Bound::Upper && ttScore <= alpha))) {
+            stats_.ttCutoffs++;
+            return ttScore;
+        }
+    }
+    
+    // Статическая оценка нужна для отсечений у листьев и нулевого хода
+    int staticEval = inCheck ? -SCORE_INFINITY : evaluateForSide(color);
+    bool boundsFinite = !isMateScore(alpha) && !isMateScore(beta);
+    bool frontierPruning = params_.futilityEnabled && !pvNode && !inCheck && boundsFinite;
+    
+    // Reverse futility (static null move): позиция настолько лучше beta,
+    // что на малой глубине противник не успеет отыграться
+    if (frontierPruning && depth < static_cast<int>(params_.reverseFutilityMargins.size()) &&
+        staticEval - params_.reverseFutilityMargins[depth] >= beta) {
+        stats_.reverseFutilityCutoffs++;
+        return staticEval - params_.reverseFutilityMargins[depth];
+    }
+    
+    // Razoring: позиция намного хуже alpha - проверяем только взятиями
+    if (frontierPruning && depth < static_cast<int>(params_.razorMargins.size()) &&
+        staticEval + params_.razorMargins[depth] < alpha) {
+        int razorScore = quiescence(alpha - 1, alpha, color, nodesSearched, ply, 0);
+        if (depth == 1 || razorScore < alpha) {
+            stats_.razorCutoffs++;
+            return razorScore;
+        }
+    }
+    
+    // Нулевой ход: не подряд (предыдущий ход - настоящий), не в проверочном
+    // поиске и не в PV-узле - отсечение там обрезало бы главный вариант
+    bool previousWasNull = ply > 0 && !moveStack_[ply - 1].isValid();
+    if (allowNull && !pvNode && !previousWasNull) {
+        int nullScore;
+        if (tryNullMovePruning(depth, beta, color, inCheck, staticEval, nodesSearched, ply,
+                               nullScore)) {
+            return nullScore;
+        }
     }
     
+    // Futility pruning: на глубине 1-2 тихий ход не поднимет оценку выше alpha
+    bool futileNode = frontierPruning && depth < static_cast<int>(params_.futilityMargins.size()) &&
+                      staticEval + params_.futilityMargins[depth] <= alpha;
+    
     MoveGenerator generator(board_);
     std::vector<Move> moves = generator.generateLegalMoves(color);
     
     // Мат или пат
     if (moves.empty()) {
-        if (board_.isCheck(color)) {
-            // Мат - очень плохо
-            return std::numeric_limits<int>::min() + 1;
+        if (inCheck) {
+            // Мат - чем ближе к корню, тем хуже
+            return matedIn(ply);
         } else {
             // Пат - ничья
             return 0;
@@ -220,64 +772,208 @@ int Engine::alphaBeta(int depth, int alpha, int beta, Color color, int& nodesSea
     }
     
     // Упорядочить ходы
-    orderMoves(moves, color);
+    orderMoves(moves, color, ply, ttMove);
     
-    int maxScore = std::numeric_limits<int>::min();
+    int maxScore = -SCORE_INFINITY;
+    Move bestMove;
+    int movesSearched = 0;
+    std::vector<Move> quietsSearched;
     
     for (const Move& move : moves) {
-        if (shouldStop_) break;
+        if (stopRequested()) break;
+        
+        bool quiet = isQuiet(move);
+        
+        // Late move pruning: при хорошем упорядочивании поздние тихие ходы
+        // на малой глубине почти никогда не улучшают alpha
+        if (params_.lmpEnabled && quiet && !inCheck && depth <= params_.lmpMaxDepth &&
+            movesSearched >= params_.lmpBaseMoves + depth * depth) {
+            stats_.lmpPruned++;
+            continue;
+        }
         
         board_.makeMove(move);
-        int score = -alphaBeta(depth - 1, -beta, -alpha, oppositeColor(color), nodesSearched);
+        moveStack_[ply] = move;
+        bool givesCheck = board_.isCheck(oppositeColor(color));
+        
+        // Futility pruning (шахи не отбрасываем - они могут изменить оценку)
+        if (futileNode && quiet && !givesCheck && movesSearched > 0) {
+            board_.unmakeMove(move);
+            stats_.futilityPruned++;
+            maxScore = std::max(maxScore, staticEval + params_.futilityMargins[depth]);
+            continue;
+        }
+        
+        int score;
+        int reduction = 0;
+        
+        // Late move reductions: поздние тихие ходы сначала ищем на меньшей
+        // глубине с нулевым окном; шахи и ходы из-под шаха не сокращаем
+        if (params_.lmrEnabled && quiet && !inCheck && depth >= params_.lmrMinDepth &&
+            movesSearched >= params_.lmrMinMoveIndex && !givesCheck) {
+            reduction = lmrReduction(depth, movesSearched);
+            if (ply < MAX_PLY && (move == killerMoves_[ply][0] || move == killerMoves_[ply][1])) {
+                reduction--;
+            }
+            reduction = std::min(std::max(reduction, 0), depth - 2);
+        }
+        
+        if (movesSearched == 0) {
+            // Первый ход - предполагаемый главный вариант, полное окно
+            score = -alphaBeta(depth - 1, -beta, -alpha, oppositeColor(color), nodesSearched, ply + 1);
+        } else {
+            // PVS: остальные ходы проверяем нулевым окном (возможно, с LMR)
+            if (reduction > 0) {
+                stats_.lmrReductions++;
+            }
+            score = -alphaBeta(depth - 1 - reduction, -alpha - 1, -alpha, oppositeColor(color),
+                               nodesSearched, ply + 1);
+            // Сокращенный ход оказался лучше ожидаемого - пересматриваем на полной глубине
+            if (reduction > 0 && score > alpha) {
+                stats_.lmrReSearches++;
+                score = -alphaBeta(depth - 1, -alpha - 1, -alpha, oppositeColor(color),
+                                   nodesSearched, ply + 1);
+            }
+            // Ход внутри окна - нужна точная оценка, пересматриваем с полным окном
+            if (score > alpha && score < beta) {
+                stats_.pvsReSearches++;
+                score = -alphaBeta(depth - 1, -beta, -alpha, oppositeColor(color),
+                                   nodesSearched, ply + 1);
+            }
+        }
+        
         board_.unmakeMove(move);
+        movesSearched++;
         
-        if (shouldStop_) break;
+        if (stopRequested()) break;
         
         if (score > maxScore) {
             maxScore = score;
+            bestMove = move;
         }
         
         if (score > alpha) {
             alpha = score;
+            updatePv(ply, move);
         }
         
         // Beta cutoff
         if (alpha >= beta) {
+            stats_.betaCutoffs++;
+            if (movesSearched == 1) {
+                stats_.firstMoveCutoffs++;
+            }
+            if (quiet) {
+                updateQuietHeuristics(move, color, depth, ply, quietsSearched);
+            }
             break;
         }
+        
+        if (quiet) {
+            quietsSearched.push_back(move);
+        }
+    }
+    
+    // Прерванный поиск дает неполные оценки - в таблицу их не пишем
+    if (!stopRequested()) {
+        Bound bound = maxScore >= beta ? Bound::Lower
+                    : maxScore > originalAlpha ? Bound::Exact
+                    : Bound::Upper;
+        tt_->store(board_.hash(), bestMove, scoreToTT(maxScore, ply), depth, bound);
     }
     
     return maxScore;
 }
 
-int Engine::quiescence(int alpha, int beta, Color color, int& nodesSearched, int depth) {
+bool Engine::tryNullMovePruning(int depth, int beta, Color color, bool inCheck, int staticEval,
+                                int& nodesSearched, int ply, int& score) {
+    if (depth < NULL_MOVE_MIN_DEPTH || isMateScore(beta) || stopRequested()) {
+        return false;
+    }
+    
+    // Под шахом пропустить ход нельзя, а в пешечных эндшпилях цугцванг -
+    // обычное дело, и предположение "ход всегда полезен" неверно
+    if (inCheck || !board_.hasNonPawnMaterial(color)) {
+        return false;
+    }
+    
+    if (staticEval < beta) {
+        return false;
+    }
+    
+    // Адаптивное сокращение: глубже и с большим запасом над beta - сильнее
+    int reduction = 2 + (depth > 6 ? 1 : 0) + std::min((staticEval - beta) / 200, 2);
+    int nullDepth = std::max(depth - 1 - reduction, 0);
+    
+    stats_.nullMoveTries++;
+    board_.makeNullMove();
+    moveStack_[ply] = Move();
+    int nullScore = -alphaBeta(nullDepth, -beta, -beta + 1, oppositeColor(color),
+                               nodesSearched, ply + 1);
+    board_.unmakeNullMove();
+    
+    if (stopRequested() || nullScore < beta) {
+        return false;
+    }
+    
+    // Мат после пропуска хода ничего не доказывает - возвращаем только beta
+    if (isMateScore(nullScore)) {
+        nullScore = beta;
+    }
+    
+    // На большой глубине подтверждаем отсечение обычным поиском без нулевого
+    // хода: в цугцванге он покажет, что на самом деле score < beta
+    if (depth >= NULL_MOVE_VERIFY_DEPTH) {
+        int verifyScore = alphaBeta(depth - reduction, beta - 1, beta, color,
+                                    nodesSearched, ply, false);
+        if (stopRequested()) {
+            return false;
+        }
+        if (verifyScore < beta) {
+            stats_.nullMoveVerifyFails++;
+            return false;
+        }
+    }
+    
+    stats_.nullMoveCutoffs++;
+    score = nullScore;
+    return true;
+}
+
+int Engine::quiescence(int alpha, int beta, Color color, int& nodesSearched, int ply, int depth) {
     nodesSearched++;
+    quiescenceNodes_++;
+    selDepth_ = std::max(selDepth_, ply + depth);
+    pollDeadline();
     
-    if (shouldStop_) {
+    if (stopRequested()) {
         return 0;
     }
     
     // Ограничиваем глубину quiescence search для ускорения
     static const int MAX_QUIESCENCE_DEPTH = 3;
     
+    // Поиск здесь fail-hard: оценке вне окна достаточно быть по ту же сторону
+    // окна, что и точная, - подойдет ленивая граница
     if (depth >= MAX_QUIESCENCE_DEPTH) {
-        Evaluator evaluator(board_);
-        int standPat = evaluator.evaluate();
-        return (color == Color::Black) ? -standPat : standPat;
+        return evaluateForSide(color, alpha, beta);
     }
     
-    // Статическая оценка
-    Evaluator evaluator(board_);
-    int standPat = evaluator.evaluate();
-    
-    if (color == Color::Black) {
-        standPat = -standPat;
-    }
+    // Статическая оценка. Ленивая - только для отсечения по beta: delta pruning
+    // ниже сравнивает оценку с alpha с точностью до взятой фигуры, ему нужна точная
+    int standPat = evaluateForSide(color, -SCORE_INFINITY, beta);
     
     if (standPat >= beta) {
         return beta;
     }
     
+    // Delta pruning: даже взятие ферзя не дотягивает до alpha
+    bool deltaPruning = params_.deltaPruningEnabled && !isMateScore(alpha);
+    if (deltaPruning && standPat + Piece(PieceType::Queen, color).value() + params_.deltaMargin < alpha) {
+        stats_.deltaPruned++;
+        return alpha;
+    }
+    
     if (alpha < standPat) {
         alpha = standPat;
     }
@@ -292,10 +988,19 @@ int Engine::quiescence(int alpha, int beta, Color color, int& nodesSearched, int
     });
     
     for (const Move& capture : captures) {
-        if (shouldStop_) break;
+        if (stopRequested()) break;
+        
+        // Delta pruning отдельного взятия (превращения меняют материал сильнее)
+        if (deltaPruning && !capture.isPromotion()) {
+            int victimValue = capture.isEnPassant() ? 100 : board_.pieceAt(capture.to()).value();
+            if (standPat + victimValue + params_.deltaMargin < alpha) {
+                stats_.deltaPruned++;
+                continue;
+            }
+        }
         
         board_.makeMove(capture);
-        int score = -quiescence(-beta, -alpha, oppositeColor(color), nodesSearched, depth + 1);
+        int score = -quiescence(-beta, -alpha, oppositeColor(color), nodesSearched, ply, depth + 1);
         board_.unmakeMove(capture);
         
         if (score >= beta) {
@@ -310,40 +1015,201 @@ int Engine::quiescence(int alpha, int beta, Color color, int& nodesSearched, int
     return alpha;
 }
 
-void Engine::orderMoves(std::vector<Move>& moves, Color color) const {
-    // Простая эвристика упорядочивания:
+int Engine::quiescenceScore(Color color) {
+    int nodes = 0;
+    return quiescence(-SCORE_INFINITY, SCORE_INFINITY, color, nodes, 0);
+}
+
+std::vector<Move> Engine::orderedMoves(Color color) {
+    MoveGenerator generator(board_);
+    std::vector<Move> moves = generator.generateLegalMoves(color);
+    orderMoves(moves, color);
+    return moves;
+}
+
+int Engine::evaluateForSide(Color color) {
+    return evaluateForSide(color, -SCORE_INFINITY, SCORE_INFINITY);
+}
+
+int Engine::evaluateForSide(Color color, int alpha, int beta) {
+    // Оценка не зависит от стороны на ходу, но ключ - полный хеш позиции
+    uint64_t key = board_.hash();
+    int score;
+    if (evalCache_->probe(key, score)) {
+        stats_.evalCacheHits++;
+    } else {
+        stats_.evalCacheMisses++;
+        if (accumulator_) {
+            // Особые эндшпили - и с сетью: реализацию KXK, KPK и т.п. она не знает.
+            // Эндшпильной части у сети нет - масштаб применяется ко всей оценке.
+            const Endgames::Entry* endgame = Endgames::probe(board_);
+            if (endgame && endgame->evaluate) {
+                score = endgame->evaluate(board_, endgame->strong);
+                if (endgame->strong == Color::Black) score = -score;
+            } else {
+                // Сеть оценивает за сторону на ходу, кеш хранит оценку за белых
+                Color side = board_.position().sideToMove();
+                score = accumulator_->evaluate(side);
+                if (side == Color::Black) score = -score;
+                if (endgame) {
+                    Color strong = (score > 0) ? Color::White : Color::Black;
+                    score = score * endgame->scale(board_, strong) / Endgames::SCALE_NORMAL;
+                }
+            }
+            evalCache_->store(key, score);
+        } else {
+            // Окно - за белых, как и оценка. В кеш идут только точные оценки.
+            bool lazy = params_.lazyEvalEnabled && (alpha > -SCORE_INFINITY || beta < SCORE_INFINITY);
+            int whiteAlpha = (color == Color::White) ? alpha : -beta;
+            int whiteBeta = (color == Color::White) ? beta : -alpha;
+            LazyExit exit;
+            Evaluator evaluator(board_, &pawnTable_);
+            score = lazy ? evaluator.evaluate(whiteAlpha, whiteBeta, &exit) : evaluator.evaluate();
+            if (!lazy || exit == LazyExit::Full) {
+                evalCache_->store(key, score);
+            } else if (exit == LazyExit::Material) {
+                stats_.lazyMaterialExits++;
+            } else {
+                stats_.lazyKingFilesExits++;
+            }
+        }
+    }
+    return (color == Color::Black) ? -score : score;
+}
+
+void Engine::updatePv(int ply, const Move& move) {
+    if (ply >= MAX_PLY) return;
+    
+    // Линия узла = ход + линия дочернего узла
+    pvTable_[ply][ply] = move;
+    int childLength = pvLength_[ply + 1];
+    for (int i = ply + 1; i < childLength; ++i) {
+        pvTable_[ply][i] = pvTable_[ply + 1][i];
+    }
+    pvLength_[ply] = std::max(childLength, ply + 1);
+}
+
+std::vector<Move> Engine::extractPv(int ply) const {
+    return std::vector<Move>(&pvTable_[ply][ply], &pvTable_[ply][0] + pvLength_[ply]);
+}
+
+void Engine::orderMoves(std::vector<Move>& moves, Color color, int ply, const Move& ttMove) const {
+    // Упорядочивание:
+    // 0. Лучший ход из таблицы транспозиций
     // 1. Взятия (MVV-LVA - Most Valuable Victim - Least Valuable Attacker)
-    // 2. Обычные ходы
+    // 2. Превращения
+    // 3. Киллеры и контрход
+    // 4. Остальные тихие ходы по history
     
-    std::sort(moves.begin(), moves.end(), [this, color](const Move& a, const Move& b) {
-        return scoreMoveForOrdering(a, color) > scoreMoveForOrdering(b, color);
+    // Оценку считаем один раз на ход, а не в каждом сравнении
+    std::vector<std::pair<int, Move>> scored;
+    scored.reserve(moves.size());
+    for (const Move& move : moves) {
+        int score = (move == ttMove) ? TT_MOVE_SCORE : scoreMoveForOrdering(move, color, ply);
+        scored.emplace_back(score, move);
+    }
+    
+    std::stable_sort(scored.begin(), scored.end(), [](const auto& a, const auto& b) {
+        return a.first > b.first;
     });
+    
+    for (size_t i = 0; i < moves.size(); ++i) {
+        moves[i] = scored[i].second;
+    }
 }
 
-int Engine::scoreMoveForOrdering(const Move& move, Color color) const {
-    int score = 0;
-    
+int Engine::scoreMoveForOrdering(const Move& move, Color color, int ply) const {
     // Взятия более приоритетны
     if (move.isCapture()) {
-        const Piece& victim = board_.pieceAt(move.to());
+        // При взятии на проходе целевая клетка пуста - жертва всегда пешка
+        int victimValue = move.isEnPassant() ? 100 : board_.pieceAt(move.to()).value();
         const Piece& attacker = board_.pieceAt(move.from());
         
         // MVV-LVA: предпочитаем брать ценные фигуры дешевыми
-        score = victim.value() * 10 - attacker.value();
+        return CAPTURE_SCORE + victimValue * 10 - attacker.value();
     }
     
-    // Превращения пешек очень ценны
+    // Превращения пешек очень ценны (ферзь первым)
     if (move.isPromotion()) {
-        score += 8000;
+        return PROMOTION_SCORE + Piece(move.promotion(), color).value();
+    }
+    
+    if (ply < 0) {
+        return 0;
+    }
+    
+    if (ply < MAX_PLY) {
+        if (move == killerMoves_[ply][0]) return KILLER_1_SCORE;
+        if (move == killerMoves_[ply][1]) return KILLER_2_SCORE;
+        
+        if (ply > 0 && moveStack_[ply - 1].isValid()) {
+            const Move& previous = moveStack_[ply - 1];
+            if (move == counterMoves_[previous.from()][previous.to()]) {
+                return COUNTER_MOVE_SCORE;
+            }
+        }
+    }
+    
+    return history_[static_cast<int>(color)][move.from()][move.to()];
+}
+
+void Engine::updateQuietHeuristics(const Move& move, Color color, int depth, int ply,
+                                   const std::vector<Move>& quietsSearched) {
+    // Киллеры: два слота, новый ход вытесняет старый
+    if (killerMoves_[ply][0] != move) {
+        killerMoves_[ply][1] = killerMoves_[ply][0];
+        killerMoves_[ply][0] = move;
     }
     
-    // Центральные ходы лучше
-    int toFile = getFile(move.to());
-    int toRank = getRank(move.to());
-    int centerDist = (toFile > 3 ? toFile - 3 : 3 - toFile) + (toRank > 3 ? toRank - 3 : 3 - toRank);
-    score += (14 - centerDist) * 10;
+    // Контрход на предыдущий ход противника (после нулевого хода - нет)
+    if (ply > 0 && moveStack_[ply - 1].isValid()) {
+        const Move& previous = moveStack_[ply - 1];
+        counterMoves_[previous.from()][previous.to()] = move;
+    }
     
-    return score;
+    // History: бонус ходу, вызвавшему отсечение, штраф тихим ходам до него
+    int bonus = std::min(32 * depth * depth, 1200);
+    updateHistory(color, move, bonus);
+    for (const Move& quiet : quietsSearched) {
+        updateHistory(color, quiet, -bonus);
+    }
+}
+
+void Engine::updateHistory(Color color, const Move& move, int bonus) {
+    // "Гравитация": чем ближе значение к MAX_HISTORY, тем меньше прирост,
+    // поэтому значения остаются в [-MAX_HISTORY, MAX_HISTORY]
+    int& entry = history_[static_cast<int>(color)][move.from()][move.to()];
+    entry += bonus - entry * std::abs(bonus) / MAX_HISTORY;
+}
+
+void Engine::resetHeuristics() {
+    for (auto& killers : killerMoves_) {
+        killers[0] = Move();
+        killers[1] = Move();
+    }
+    for (auto& byColor : history_) {
+        for (auto& byFrom : byColor) {
+            std::fill(std::begin(byFrom), std::end(byFrom), 0);
+        }
+    }
+    for (auto& byFrom : counterMoves_) {
+        std::fill(std::begin(byFrom), std::end(byFrom), Move());
+    }
+}
+
+void Engine::ageHistory() {
+    // Между поисками позиция меняется: киллеры сбрасываем, history ослабляем
+    for (auto& killers : killerMoves_) {
+        killers[0] = Move();
+        killers[1] = Move();
+    }
+    for (auto& byColor : history_) {
+        for (auto& byFrom : byColor) {
+            for (int& entry : byFrom) {
+                entry /= 2;
+            }
+        }
+    }
 }
 
 void Engine::log(const std::string& message) {
@@ -375,6 +1241,8 @@ void Engine::logSearchStart(Color color, int depth, int timeLimit) {
     }
     ss << ", FEN=" << board_.toFEN();
     log(ss.str());
+    log("Размещение: " + describePlacement() + "; хеш " + std::to_string(tt_->sizeMb()) +
+        " МБ, " + tt_->placement());
 }
 
 void Engine::logMoveEvaluation(const Move& move, int score, int depth, int nodes) {
@@ -388,97 +1256,43 @@ void Engine::logSearchResult(const SearchResult& result) {
     std::stringstream ss;
     ss << "Результат поиска: ход=" << result.bestMove.toLongAlgebraic()
        << " | оценка=" << result.score
-       << " | глубина=" << result.depth
+       << " | глубина=" << result.depth << "/" << result.selDepth
        << " | узлов=" << result.nodesSearched
-       << " | время=" << std::fixed << std::setprecision(2) << result.timeSpent << "с";
+       << " (основной " << result.mainNodes << ", quiescence " << result.quiescenceNodes << ")"
+       << " | время=" << std::fixed << std::setprecision(2) << result.timeSpent << "с"
+       << " | отсечений на 1-м ходе=" << std::setprecision(1)
+       << result.stats.firstMoveCutoffRate() * 100.0 << "%"
+       << " | null-move отсечений=" << result.stats.nullMoveCutoffs
+       << "/" << result.stats.nullMoveTries
+       << " | LMR=" << result.stats.lmrReductions
+       << " (пересмотров " << result.stats.lmrReSearches << ")"
+       << " | LMP=" << result.stats.lmpPruned
+       << " | PVS пересмотров=" << result.stats.pvsReSearches
+       << " | RFP=" << result.stats.reverseFutilityCutoffs
+       << " | razoring=" << result.stats.razorCutoffs
+       << " | futility=" << result.stats.futilityPruned
+       << " | delta=" << result.stats.deltaPruned
+       << " | TT отсечений=" << result.stats.ttCutoffs
+       << " | продлений шахов=" << result.stats.checkExtensions
+       << " | KPK ничьих=" << result.stats.bitbaseDraws
+       << " | кеш оценок=" << std::setprecision(1) << result.stats.evalCacheHitRate() * 100.0 << "%"
+       << " (" << result.stats.evalCacheHits << "/"
+       << result.stats.evalCacheHits + result.stats.evalCacheMisses << ")"
+       << " | ленивых выходов=" << result.stats.lazyMaterialExits
+       << "+" << result.stats.lazyKingFilesExits
+       << " | hashfull=" << tt_->hashfull() << "‰"
+       << " | PV: " << pvToString(result.pv);
     log(ss.str());
 }
 
-int Engine::checkPositionRepetition(const std::string& fen) const {
-    // Извлекаем только позицию фигур из FEN (до первого пробела)
-    // Это позволяет игнорировать информацию о ходе, рокировке и т.д.
-    size_t spacePos = fen.find(' ');
-    std::string positionOnly = (spacePos != std::string::npos) ? fen.substr(0, spacePos) : fen;
-    
-    // Используем thread_local для безопасности в многопоточности
-    static thread_local std::vector<std::string> recentPositions;
-    
-    // Проверяем, встречалась ли эта позиция недавно
-    int count = 0;
-    for (const auto& pos : recentPositions) {
-        if (pos == positionOnly) {
-            count++;
-        }
-    }
-    
-    // Если позиция повторяется 2 или более раз, применяем штраф
-    if (count >= 2) {
+int Engine::checkPositionRepetition() const {
+    // Позиция после хода уже была дважды - ход ведет к троекратному повторению.
+    // Считаем по истории партии на доске: результат зависит только от позиции.
+    if (board_.repetitionCount() >= 2) {
         return 500;  // Штраф за повторение позиции
     }
-    
-    // Добавляем текущую позицию в историю (храним последние 10 позиций)
-    recentPositions.push_back(positionOnly);
-    if (recentPositions.size() > 10) {
-        recentPositions.erase(recentPositions.begin());
-    }
-    
     return 0;
 }
 
-bool Engine::isKingOnlyEndgame(const Board& board, Color color) const {
-    // Проверяем, остались ли у противника только король
-    Color opponentColor = oppositeColor(color);
-    int pieceCount = 0;
-    
-    for (Square sq = 0; sq < NUM_SQUARES; ++sq) {
-        const Piece& piece = board.pieceAt(sq);
-        if (!piece.isNone() && piece.color() == opponentColor) {
-            if (piece.type() == PieceType::King) {
-                pieceCount++;
-            } else {
-                return false;  // Есть не-король
-            }
-        }
-    }
-    
-    return pieceCount == 1;  // Только король
-}
-
-int Engine::evaluateEndgameMate(const Board& board, Color color) const {
-    // Если у противника только король, нужно приближаться к нему для мата
-    if (!isKingOnlyEndgame(board, color)) {
-        return 0;
-    }
-    
-    Color opponentColor = oppositeColor(color);
-    Square opponentKing = board.findKing(opponentColor);
-    Square myKing = board.findKing(color);
-    
-    if (opponentKing == 255 || myKing == 255) {
-        return 0;
-    }
-    
-    // Вычисляем расстояние между королями
-    int opponentFile = getFile(opponentKing);
-    int opponentRank = getRank(opponentKing);
-    int myFile = getFile(myKing);
-    int myRank = getRank(myKing);
-    
-    int fileDiff = (opponentFile > myFile) ? (opponentFile - myFile) : (myFile - opponentFile);
-    int rankDiff = (opponentRank > myRank) ? (opponentRank - myRank) : (myRank - opponentRank);
-    int distance = fileDiff + rankDiff;
-    
-    // Бонус за приближение к королю противника (максимальное расстояние = 14)
-    // Чем ближе, тем больше бонус
-    int bonus = (14 - distance) * 20;
-    
-    // Также проверяем, можем ли мы атаковать короля
-    if (board.isSquareAttacked(opponentKing, color)) {
-        bonus += 100;  // Дополнительный бонус за атаку короля
-    }
-    
-    return bonus;
-}
-
 }} // namespace Chess::AI
 
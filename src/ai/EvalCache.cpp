@@ -0,0 +1,30 @@
+#include "ai/EvalCache.h"
+#include <algorithm>
+
+namespace Chess {
+namespace AI {
+
+EvalCache::EvalCache(size_t sizeMb) {
+    resize(sizeMb);
+}
+
+void EvalCache::resize(size_t sizeMb) {
+    // Число слотов - степень двойки, не больше заданного размера
+    size_t maxSlots = std::max<size_t>(sizeMb, 1) * 1024 * 1024 / sizeof(uint64_t);
+    size_t slots = 1;
+    while (slots * 2 <= maxSlots) {
+        slots *= 2;
+    }
+    slots_.reset(new std::atomic<uint64_t>[slots]);
+    mask_ = slots - 1;
+    sizeMb_ = sizeMb;
+    clear();
+}
+
+void EvalCache::clear() {
+    for (size_t i = 0; i <= mask_; ++i) {
+        slots_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+}} // namespace Chess::AI
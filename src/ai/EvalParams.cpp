@@ -0,0 +1,101 @@
+#include "ai/EvalParams.h"
+
+namespace Chess {
+namespace AI {
+
+// Файл в этом формате печатает chess-tune: настроенные параметры заменяют его целиком.
+const EvalParams DEFAULT_EVAL_PARAMS = {
+    // Материал: пешка, конь, слон, ладья, ферзь, король
+    {{ 100, 100}, { 320, 320}, { 330, 330}, { 500, 500}, { 900, 900}, {   0,   0}},
+
+    // Piece-Square Tables со стороны белых, первая строка - 8-я горизонталь
+    {
+        // Пешка
+        {
+            {   0,   0}, {   0,   0}, {   0,   0}, {   0,   0}, {   0,   0}, {   0,   0}, {   0,   0}, {   0,   0},
+            {  50,  80}, {  50,  80}, {  50,  80}, {  50,  80}, {  50,  80}, {  50,  80}, {  50,  80}, {  50,  80},
+            {  10,  50}, {  10,  50}, {  20,  50}, {  30,  50}, {  30,  50}, {  20,  50}, {  10,  50}, {  10,  50},
+            {   5,  30}, {   5,  30}, {  10,  30}, {  25,  30}, {  25,  30}, {  10,  30}, {   5,  30}, {   5,  30},
+            {   0,  15}, {   0,  15}, {   0,  15}, {  20,  15}, {  20,  15}, {   0,  15}, {   0,  15}, {   0,  15},
+            {   5,   5}, {  -5,   5}, { -10,   5}, {   0,   5}, {   0,   5}, { -10,   5}, {  -5,   5}, {   5,   5},
+            {   5,   0}, {  10,   0}, {  10,   0}, { -20,   0}, { -20,   0}, {  10,   0}, {  10,   0}, {   5,   0},
+            {   0,   0}, {   0,   0}, {   0,   0}, {   0,   0}, {   0,   0}, {   0,   0}, {   0,   0}, {   0,   0}
+        },
+        // Конь
+        {
+            { -50, -50}, { -40, -40}, { -30, -30}, { -30, -30}, { -30, -30}, { -30, -30}, { -40, -40}, { -50, -50},
+            { -40, -40}, { -20, -20}, {   0,   0}, {   0,   0}, {   0,   0}, {   0,   0}, { -20, -20}, { -40, -40},
+            { -30, -30}, {   0,   0}, {  10,  10}, {  15,  15}, {  15,  15}, {  10,  10}, {   0,   0}, { -30, -30},
+            { -30, -30}, {   5,   5}, {  15,  15}, {  20,  20}, {  20,  20}, {  15,  15}, {   5,   5}, { -30, -30},
+            { -30, -30}, {   0,   0}, {  15,  15}, {  20,  20}, {  20,  20}, {  15,  15}, {   0,   0}, { -30, -30},
+            { -30, -30}, {   5,   5}, {  10,  10}, {  15,  15}, {  15,  15}, {  10,  10}, {   5,   5}, { -30, -30},
+            { -40, -40}, { -20, -20}, {   0,   0}, {   5,   5}, {   5,   5}, {   0,   0}, { -20, -20}, { -40, -40},
+            { -50, -50}, { -40, -40}, { -30, -30}, { -30, -30}, { -30, -30}, { -30, -30}, { -40, -40}, { -50, -50}
+        },
+        // Слон
+        {
+            { -20, -20}, { -10, -10}, { -10, -10}, { -10, -10}, { -10, -10}, { -10, -10}, { -10, -10}, { -20, -20},
+            { -10, -10}, {   0,   0}, {   0,   0}, {   0,   0}, {   0,   0}, {   0,   0}, {   0,   0}, { -10, -10},
+            { -10, -10}, {   0,   0}, {   5,   5}, {  10,  10}, {  10,  10}, {   5,   5}, {   0,   0}, { -10, -10},
+            { -10, -10}, {   5,   5}, {   5,   5}, {  10,  10}, {  10,  10}, {   5,   5}, {   5,   5}, { -10, -10},
+            { -10, -10}, {   0,   0}, {  10,  10}, {  10,  10}, {  10,  10}, {  10,  10}, {   0,   0}, { -10, -10},
+            { -10, -10}, {  10,  10}, {  10,  10}, {  10,  10}, {  10,  10}, {  10,  10}, {  10,  10}, { -10, -10},
+            { -10, -10}, {   5,   5}, {   0,   0}, {   0,   0}, {   0,   0}, {   0,   0}, {   5,   5}, { -10, -10},
+            { -20, -20}, { -10, -10}, { -10, -10}, { -10, -10}, { -10, -10}, { -10, -10}, { -10, -10}, { -20, -20}
+        },
+        // Ладья
+        {
+            {   0,   0}, {   0,   0}, {   0,   0}, {   0,   0}, {   0,   0}, {   0,   0}, {   0,   0}, {   0,   0},
+            {   5,   5}, {  10,  10}, {  10,  10}, {  10,  10}, {  10,  10}, {  10,  10}, {  10,  10}, {   5,   5},
+            {  -5,  -5}, {   0,   0}, {   0,   0}, {   0,   0}, {   0,   0}, {   0,   0}, {   0,   0}, {  -5,  -5},
+            {  -5,  -5}, {   0,   0}, {   0,   0}, {   0,   0}, {   0,   0}, {   0,   0}, {   0,   0}, {  -5,  -5},
+            {  -5,  -5}, {   0,   0}, {   0,   0}, {   0,   0}, {   0,   0}, {   0,   0}, {   0,   0}, {  -5,  -5},
+            {  -5,  -5}, {   0,   0}, {   0,   0}, {   0,   0}, {   0,   0}, {   0,   0}, {   0,   0}, {  -5,  -5},
+            {  -5,  -5}, {   0,   0}, {   0,   0}, {   0,   0}, {   0,   0}, {   0,   0}, {   0,   0}, {  -5,  -5},
+            {   0,   0}, {   0,   0}, {   0,   0}, {   5,   5}, {   5,   5}, {   0,   0}, {   0,   0}, {   0,   0}
+        },
+        // Ферзь
+        {
+            { -20, -20}, { -10, -10}, { -10, -10}, {  -5,  -5}, {  -5,  -5}, { -10, -10}, { -10, -10}, { -20, -20},
+            { -10, -10}, {   0,   0}, {   0,   0}, {   0,   0}, {   0,   0}, {   0,   0}, {   0,   0}, { -10, -10},
+            { -10, -10}, {   0,   0}, {   5,   5}, {   5,   5}, {   5,   5}, {   5,   5}, {   0,   0}, { -10, -10},
+            {  -5,  -5}, {   0,   0}, {   5,   5}, {   5,   5}, {   5,   5}, {   5,   5}, {   0,   0}, {  -5,  -5},
+            {   0,   0}, {   0,   0}, {   5,   5}, {   5,   5}, {   5,   5}, {   5,   5}, {   0,   0}, {  -5,  -5},
+            { -10, -10}, {   5,   5}, {   5,   5}, {   5,   5}, {   5,   5}, {   5,   5}, {   0,   0}, { -10, -10},
+            { -10, -10}, {   0,   0}, {   5,   5}, {   0,   0}, {   0,   0}, {   0,   0}, {   0,   0}, { -10, -10},
+            { -20, -20}, { -10, -10}, { -10, -10}, {  -5,  -5}, {  -5,  -5}, { -10, -10}, { -10, -10}, { -20, -20}
+        },
+        // Король
+        {
+            { -30, -50}, { -40, -40}, { -40, -30}, { -50, -20}, { -50, -20}, { -40, -30}, { -40, -40}, { -30, -50},
+            { -30, -30}, { -40, -20}, { -40, -10}, { -50,   0}, { -50,   0}, { -40, -10}, { -40, -20}, { -30, -30},
+            { -30, -30}, { -40, -10}, { -40,  20}, { -50,  30}, { -50,  30}, { -40,  20}, { -40, -10}, { -30, -30},
+            { -30, -30}, { -40, -10}, { -40,  30}, { -50,  40}, { -50,  40}, { -40,  30}, { -40, -10}, { -30, -30},
+            { -20, -30}, { -30, -10}, { -30,  30}, { -40,  40}, { -40,  40}, { -30,  30}, { -30, -10}, { -20, -30},
+            { -10, -30}, { -20, -10}, { -20,  20}, { -20,  30}, { -20,  30}, { -20,  20}, { -20, -10}, { -10, -30},
+            {  20, -30}, {  20, -30}, {   0,   0}, {   0,   0}, {   0,   0}, {   0,   0}, {  20, -30}, {  20, -30},
+            {  20, -50}, {  30, -30}, {  10, -30}, {   0, -30}, {   0, -30}, {  10, -30}, {  30, -30}, {  20, -50}
+        }
+    },
+
+    // Сдвоенная и изолированная пешка
+    { -20, -30},
+    { -15, -20},
+
+    // Проходная пешка по горизонтали
+    {{   0,   0}, {   5,  10}, {  10,  20}, {  15,  35}, {  25,  60}, {  40,  90}, {  60, 130}, {   0,   0}},
+
+    // Пешечный щит и полуоткрытая вертикаль у короля
+    {  10,   0},
+    { -15,   0},
+
+    // Ладья на открытой и полуоткрытой вертикали, конь на форпосте
+    {  20,  10},
+    {  10,   5},
+    {  20,  10},
+
+    // Подвижность: конь, слон, ладья, ферзь
+    {{   4,   4}, {   5,   5}, {   2,   4}, {   1,   2}}
+};
+
+}} // namespace Chess::AI
@@ -1,284 +1,454 @@
 #include "ai/Evaluator.h"
-#include "core/MoveGenerator.h"
+#include "ai/Endgame.h"
+#include "ai/Score.h"
+#include "core/Bitboards.h"
+#include <algorithm>
+#include <cstdlib>
+
+// AVX2-ядро материала и PSQT - для x86 на GCC/Clang, выбирается при запуске
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define CHESS_EVAL_X86 1
+#include <immintrin.h>
+#endif
 
 namespace Chess {
 namespace AI {
 
-// Piece-Square Tables (из Stockfish, упрощенные)
-const int Evaluator::PAWN_TABLE[64] = {
-     0,  0,  0,  0,  0,  0,  0,  0,
-    50, 50, 50, 50, 50, 50, 50, 50,
-    10, 10, 20, 30, 30, 20, 10, 10,
-     5,  5, 10, 25, 25, 10,  5,  5,
-     0,  0,  0, 20, 20,  0,  0,  0,
-     5, -5,-10,  0,  0,-10, -5,  5,
-     5, 10, 10,-20,-20, 10, 10,  5,
-     0,  0,  0,  0,  0,  0,  0,  0
-};
+namespace {
 
-const int Evaluator::KNIGHT_TABLE[64] = {
-    -50,-40,-30,-30,-30,-30,-40,-50,
-    -40,-20,  0,  0,  0,  0,-20,-40,
-    -30,  0, 10, 15, 15, 10,  0,-30,
-    -30,  5, 15, 20, 20, 15,  5,-30,
-    -30,  0, 15, 20, 20, 15,  0,-30,
-    -30,  5, 10, 15, 15, 10,  5,-30,
-    -40,-20,  0,  5,  5,  0,-20,-40,
-    -50,-40,-30,-30,-30,-30,-40,-50
+// Подвижность по типам фигур (в порядке EvalParams::mobility): "нормальное"
+// число клеток, относительно которого считается бонус
+struct MobilityCenter {
+    PieceType type;
+    int center;
+    int maxSquares;     // Больше клеток фигура не атакует ни с какого поля
 };
 
-const int Evaluator::BISHOP_TABLE[64] = {
-    -20,-10,-10,-10,-10,-10,-10,-20,
-    -10,  0,  0,  0,  0,  0,  0,-10,
-    -10,  0,  5, 10, 10,  5,  0,-10,
-    -10,  5,  5, 10, 10,  5,  5,-10,
-    -10,  0, 10, 10, 10, 10,  0,-10,
-    -10, 10, 10, 10, 10, 10, 10,-10,
-    -10,  5,  0,  0,  0,  0,  5,-10,
-    -20,-10,-10,-10,-10,-10,-10,-20
+constexpr MobilityCenter MOBILITY_CENTERS[] = {
+    {PieceType::Knight, 4,  8},
+    {PieceType::Bishop, 6,  13},
+    {PieceType::Rook,   6,  14},
+    {PieceType::Queen,  12, 27},
 };
 
-const int Evaluator::ROOK_TABLE[64] = {
-     0,  0,  0,  0,  0,  0,  0,  0,
-     5, 10, 10, 10, 10, 10, 10,  5,
-    -5,  0,  0,  0,  0,  0,  0, -5,
-    -5,  0,  0,  0,  0,  0,  0, -5,
-    -5,  0,  0,  0,  0,  0,  0, -5,
-    -5,  0,  0,  0,  0,  0,  0, -5,
-    -5,  0,  0,  0,  0,  0,  0, -5,
-     0,  0,  0,  5,  5,  0,  0,  0
+// Запасы ленивой оценки - верхние границы того, на сколько еще не посчитанные
+// слагаемые могут сдвинуть оценку. Выводятся из параметров оценки, а не из
+// партий: вес (больший из mg и eg - смесь по фазе между ними) на наибольшее
+// число срабатываний. Вклады белых и черных складываются по модулю.
+struct LazyBounds {
+    int mobility[4];    // На фигуру: вес клетки на наибольшее отклонение от центра
+    int king;           // На сторону: щит и полуоткрытые вертикали на трех вертикалях
+    int rookFile;       // На ладью
+    int outpost;        // На коня
 };
 
-const int Evaluator::QUEEN_TABLE[64] = {
-    -20,-10,-10, -5, -5,-10,-10,-20,
-    -10,  0,  0,  0,  0,  0,  0,-10,
-    -10,  0,  5,  5,  5,  5,  0,-10,
-     -5,  0,  5,  5,  5,  5,  0, -5,
-      0,  0,  5,  5,  5,  5,  0, -5,
-    -10,  5,  5,  5,  5,  5,  0,-10,
-    -10,  0,  5,  0,  0,  0,  0,-10,
-    -20,-10,-10, -5, -5,-10,-10,-20
-};
+int weightBound(const PhaseScore& weight) {
+    return std::max(std::abs(weight.mg), std::abs(weight.eg));
+}
 
-const int Evaluator::KING_MIDDLE_GAME_TABLE[64] = {
-    -30,-40,-40,-50,-50,-40,-40,-30,
-    -30,-40,-40,-50,-50,-40,-40,-30,
-    -30,-40,-40,-50,-50,-40,-40,-30,
-    -30,-40,-40,-50,-50,-40,-40,-30,
-    -20,-30,-30,-40,-40,-30,-30,-20,
-    -10,-20,-20,-20,-20,-20,-20,-10,
-     20, 20,  0,  0,  0,  0, 20, 20,
-     20, 30, 10,  0,  0, 10, 30, 20
-};
+LazyBounds buildLazyBounds(const EvalParams& params) {
+    LazyBounds bounds = {};
+    for (int i = 0; i < 4; ++i) {
+        const MobilityCenter& mobility = MOBILITY_CENTERS[i];
+        int deviation = std::max(mobility.center, mobility.maxSquares - mobility.center);
+        bounds.mobility[i] = weightBound(params.mobility[i]) * deviation;
+    }
+    bounds.king = 3 * (weightBound(params.pawnShield) + weightBound(params.kingSemiOpenFile));
+    bounds.rookFile = std::max(weightBound(params.rookOpenFile), weightBound(params.rookSemiOpenFile));
+    bounds.outpost = weightBound(params.knightOutpost);
+    return bounds;
+}
 
-const int Evaluator::KING_END_GAME_TABLE[64] = {
-    -50,-40,-30,-20,-20,-30,-40,-50,
-    -30,-20,-10,  0,  0,-10,-20,-30,
-    -30,-10, 20, 30, 30, 20,-10,-30,
-    -30,-10, 30, 40, 40, 30,-10,-30,
-    -30,-10, 30, 40, 40, 30,-10,-30,
-    -30,-10, 20, 30, 30, 20,-10,-30,
-    -30,-30,  0,  0,  0,  0,-30,-30,
-    -50,-30,-30,-30,-30,-30,-30,-50
+const LazyBounds LAZY_BOUNDS = buildLazyBounds(DEFAULT_EVAL_PARAMS);
+
+// Фигур типа type у обеих сторон
+int pieceCount(const Board& board, PieceType type) {
+    return Bitboards::popCount(board.pieces(Color::White, type) | board.pieces(Color::Black, type));
+}
+
+// Запас на подвижность; +1 - округление при смеси по фазе
+int lazyMobilityMargin(const Board& board) {
+    int margin = 1;
+    for (int i = 0; i < 4; ++i) {
+        margin += LAZY_BOUNDS.mobility[i] * pieceCount(board, MOBILITY_CENTERS[i].type);
+    }
+    return margin;
+}
+
+// Запас на короля и линии (ладьи, форпосты)
+int lazyKingFilesMargin(const Board& board) {
+    return 1 + 2 * LAZY_BOUNDS.king + LAZY_BOUNDS.rookFile * pieceCount(board, PieceType::Rook) +
+           LAZY_BOUNDS.outpost * pieceCount(board, PieceType::Knight);
+}
+
+// Частичная оценка partial +- margin целиком за окном. Запас - граница, поэтому
+// сама partial лежит по ту же сторону окна, что и точная оценка, и ближе к ней,
+// чем граница partial +- margin.
+bool outsideWindow(int partial, int margin, int alpha, int beta) {
+    return partial + margin <= alpha || partial - margin >= beta;
+}
+
+// Половина доски соперника: горизонтали 5-8 для белых, 1-4 для черных
+constexpr Bitboard ENEMY_HALF[2] = {0xFFFFFFFF00000000ULL, 0x00000000FFFFFFFFULL};
+
+// Материал + PSQT по коду фигуры (Board::pieceCode) и клетке, уже со знаком
+// стороны: оценка - сумма по 64 клеткам без ветвлений. Пустые и
+// неиспользуемые коды - нули. Индекс - код * 64 + клетка.
+struct PieceTable {
+    alignas(32) int32_t mg[Board::NUM_PIECE_CODES * NUM_SQUARES];
+    alignas(32) int32_t eg[Board::NUM_PIECE_CODES * NUM_SQUARES];
 };
 
-Evaluator::Evaluator(const Board& board) : board_(board) {}
+PieceTable buildPieceTable(const EvalParams& params) {
+    PieceTable table = {};
+    for (Color color : {Color::White, Color::Black}) {
+        int sign = (color == Color::White) ? 1 : -1;
+        for (int type = 0; type < 6; ++type) {
+            int code = Board::pieceCode(Piece(static_cast<PieceType>(type + 1), color));
+            for (Square sq = 0; sq < NUM_SQUARES; ++sq) {
+                Square index = (color == Color::White) ? (sq ^ 56) : sq;
+                table.mg[code * NUM_SQUARES + sq] = sign * (params.material[type].mg + params.psqt[type][index].mg);
+                table.eg[code * NUM_SQUARES + sq] = sign * (params.material[type].eg + params.psqt[type][index].eg);
+            }
+        }
+    }
+    return table;
+}
+
+const PieceTable PIECE_TABLE = buildPieceTable(DEFAULT_EVAL_PARAMS);
+
+using PieceKernelFn = void (*)(const uint8_t* codes, PhaseScore& score);
+
+void piecesScalar(const uint8_t* codes, PhaseScore& score) {
+    int mg = 0, eg = 0;
+    for (Square sq = 0; sq < NUM_SQUARES; ++sq) {
+        int index = codes[sq] * NUM_SQUARES + sq;
+        mg += PIECE_TABLE.mg[index];
+        eg += PIECE_TABLE.eg[index];
+    }
+    score.mg += mg;
+    score.eg += eg;
+}
+
+#ifdef CHESS_EVAL_X86
+__attribute__((target("avx2")))
+int32_t horizontalSum(__m256i sum) {
+    __m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+    half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0x4E));
+    half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0xB1));
+    return _mm_cvtsi128_si32(half);
+}
+
+// 8 клеток за шаг: коды расширяются до int32, индекс код * 64 + клетка,
+// mg и eg собираются gather из таблицы; пустые восьмерки клеток (их много в
+// эндшпиле) пропускаются. Сложение int32 ассоциативно - результат совпадает
+// со скалярным бит в бит.
+__attribute__((target("avx2")))
+void piecesAvx2(const uint8_t* codes, PhaseScore& score) {
+    __m256i squares = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i step = _mm256_set1_epi32(8);
+    __m256i mg = _mm256_setzero_si256();
+    __m256i eg = _mm256_setzero_si256();
+    for (int sq = 0; sq < NUM_SQUARES; sq += 8) {
+        __m128i packed = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(codes + sq));
+        if (_mm_testz_si128(packed, packed)) {
+            squares = _mm256_add_epi32(squares, step);
+            continue;
+        }
+        __m256i index = _mm256_add_epi32(_mm256_slli_epi32(_mm256_cvtepu8_epi32(packed), 6), squares);
+        mg = _mm256_add_epi32(mg, _mm256_i32gather_epi32(PIECE_TABLE.mg, index, 4));
+        eg = _mm256_add_epi32(eg, _mm256_i32gather_epi32(PIECE_TABLE.eg, index, 4));
+        squares = _mm256_add_epi32(squares, step);
+    }
+    score.mg += horizontalSum(mg);
+    score.eg += horizontalSum(eg);
+}
+#endif
+
+PieceKernelFn pieceKernelFor(PieceKernel kernel) {
+#ifdef CHESS_EVAL_X86
+    if (kernel == PieceKernel::Avx2) return piecesAvx2;
+#endif
+    return (kernel == PieceKernel::Scalar) ? piecesScalar : nullptr;
+}
+
+PieceKernel detectPieceKernel() {
+#ifdef CHESS_EVAL_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return PieceKernel::Avx2;
+#endif
+    return PieceKernel::Scalar;
+}
+
+const PieceKernel DETECTED_KERNEL = detectPieceKernel();
+PieceKernel currentKernel = DETECTED_KERNEL;
+PieceKernelFn pieceKernelFn = pieceKernelFor(DETECTED_KERNEL);
+
+} // namespace
+
+const EvalParams& Evaluator::params_ = DEFAULT_EVAL_PARAMS;
+
+PieceKernel Evaluator::detectedPieceKernel() {
+    return DETECTED_KERNEL;
+}
+
+PieceKernel Evaluator::pieceKernel() {
+    return currentKernel;
+}
+
+void Evaluator::setPieceKernel(PieceKernel kernel) {
+    currentKernel = std::min(kernel, DETECTED_KERNEL);
+    pieceKernelFn = pieceKernelFor(currentKernel);
+}
+
+const char* Evaluator::pieceKernelName(PieceKernel kernel) {
+    switch (kernel) {
+        case PieceKernel::Avx2:   return "AVX2";
+        case PieceKernel::Scalar: return "scalar";
+        default:                  return "reference";
+    }
+}
+
+Evaluator::Evaluator(const Board& board, PawnHashTable* pawnTable)
+    : board_(board), pawnTable_(pawnTable) {}
 
 int Evaluator::evaluate() const {
-    int score = 0;
-    
-    score += evaluateMaterial();
-    score += evaluatePosition();
-    score += evaluateMobility();
-    score += evaluateKingSafety();
-    score += evaluatePawnStructure();
-    
-    return score;
+    return evaluate(-SCORE_INFINITY, SCORE_INFINITY);
 }
 
-int Evaluator::evaluateMaterial() const {
-    int score = 0;
+int Evaluator::evaluate(int alpha, int beta, LazyExit* exit) const {
+    // Особые эндшпили - по материальной сигнатуре. При разложении для тюнера
+    // не применяются: их оценка не линейна по EvalParams.
+    const Endgames::Entry* endgame = trace_ ? nullptr : Endgames::probe(board_);
+    if (endgame && endgame->evaluate) {
+        if (exit) *exit = LazyExit::Full;
+        int result = endgame->evaluate(board_, endgame->strong);
+        return (endgame->strong == Color::White) ? result : -result;
+    }
+    // Масштаб меняет эндшпильную часть целиком - частичная сумма итог не ограничивает
+    if (endgame) {
+        alpha = -SCORE_INFINITY;
+        beta = SCORE_INFINITY;
+    }
     
-    for (Square sq = 0; sq < NUM_SQUARES; ++sq) {
-        const Piece& piece = board_.pieceAt(sq);
-        if (piece.isNone()) continue;
-        
-        int value = piece.value();
-        score += (piece.isWhite() ? value : -value);
+    PhaseScore score;
+    
+    // Материал, PSQT и пешки (обычно из кеша) - основная часть оценки
+    PawnEntry local;
+    const PawnEntry& pawns = probePawns(local);
+    score.mg += pawns.mg;
+    score.eg += pawns.eg;
+    evaluatePieces(score);
+    int partial = blend(score);
+    int mobilityMargin = lazyMobilityMargin(board_);
+    if (outsideWindow(partial, mobilityMargin + lazyKingFilesMargin(board_), alpha, beta)) {
+        if (exit) *exit = LazyExit::Material;
+        return partial;
+    }
+    
+    evaluateKingSafety(pawns, score);
+    evaluatePieceFiles(pawns, score);
+    partial = blend(score);
+    if (outsideWindow(partial, mobilityMargin, alpha, beta)) {
+        if (exit) *exit = LazyExit::KingAndFiles;
+        return partial;
     }
     
-    return score;
+    // Подвижность - самое дорогое слагаемое: атаки всех фигур
+    evaluateMobility(pawns, score);
+    if (exit) *exit = LazyExit::Full;
+    if (endgame) {
+        Color strong = (score.eg > 0) ? Color::White : Color::Black;
+        score.eg = score.eg * endgame->scale(board_, strong) / Endgames::SCALE_NORMAL;
+    }
+    return blend(score);
 }
 
-int Evaluator::evaluatePosition() const {
-    int score = 0;
-    
+void Evaluator::evaluatePieces(PhaseScore& score) const {
+    // Разложение для тюнера требует знать каждую фигуру - только эталон
+    if (trace_ || !pieceKernelFn) {
+        evaluatePiecesReference(score);
+        return;
+    }
+    pieceKernelFn(board_.pieceCodes(), score);
+}
+
+void Evaluator::evaluatePiecesReference(PhaseScore& score) const {
     for (Square sq = 0; sq < NUM_SQUARES; ++sq) {
         const Piece& piece = board_.pieceAt(sq);
         if (piece.isNone()) continue;
         
-        int psqValue = getPieceSquareValue(piece, sq);
-        score += (piece.isWhite() ? psqValue : -psqValue);
+        // Таблицы записаны сверху вниз со стороны белых; для черных - как есть
+        int type = static_cast<int>(piece.type()) - 1;
+        int sign = piece.isWhite() ? 1 : -1;
+        Square index = piece.isWhite() ? (sq ^ 56) : sq;
+        add(score, params_.material[type], sign);
+        add(score, params_.psqt[type][index], sign);
     }
-    
-    return score;
 }
 
-int Evaluator::getPieceSquareValue(const Piece& piece, Square sq) const {
-    // Переворачиваем таблицу для черных
-    Square index = sq;
-    if (piece.isBlack()) {
-        index = makeSquare(getFile(sq), 7 - getRank(sq));
-    }
-    
-    switch (piece.type()) {
-        case PieceType::Pawn:
-            return PAWN_TABLE[index];
-        case PieceType::Knight:
-            return KNIGHT_TABLE[index];
-        case PieceType::Bishop:
-            return BISHOP_TABLE[index];
-        case PieceType::Rook:
-            return ROOK_TABLE[index];
-        case PieceType::Queen:
-            return QUEEN_TABLE[index];
-        case PieceType::King:
-            if (isEndgame()) {
-                return KING_END_GAME_TABLE[index];
-            } else {
-                return KING_MIDDLE_GAME_TABLE[index];
-            }
-        default:
-            return 0;
-    }
+void Evaluator::evaluateMobility(const PawnEntry& pawns, PhaseScore& score) const {
+    evaluateMobility(pawns, Color::White, score);
+    evaluateMobility(pawns, Color::Black, score);
 }
 
-int Evaluator::evaluateMobility() const {
-    MoveGenerator whiteGen(board_);
-    MoveGenerator blackGen(board_);
+void Evaluator::evaluateMobility(const PawnEntry& pawns, Color color, PhaseScore& score) const {
+    using namespace Bitboards;
     
-    int whiteMobility = whiteGen.generateLegalMoves(Color::White).size();
-    int blackMobility = blackGen.generateLegalMoves(Color::Black).size();
-    
-    return (whiteMobility - blackMobility) * 10;
-}
-
-int Evaluator::evaluateKingSafety() const {
-    int score = 0;
+    // Подвижность - число атакуемых клеток, не занятых своими фигурами и не
+    // битых пешками соперника. Считается по атакам, ходы не генерируются.
+    Bitboard occupied = board_.occupied();
+    Bitboard safe = ~board_.occupied(color) & ~pawns.attacks[static_cast<int>(oppositeColor(color))];
+    int sign = (color == Color::White) ? 1 : -1;
     
-    // Упрощенная оценка безопасности короля
-    Square whiteKing = board_.findKing(Color::White);
-    Square blackKing = board_.findKing(Color::Black);
-    
-    if (whiteKing != 255 && !isEndgame()) {
-        // Проверка наличия пешек перед королем
-        int file = getFile(whiteKing);
-        int rank = getRank(whiteKing);
-        
-        for (int df = -1; df <= 1; ++df) {
-            int checkFile = file + df;
-            if (checkFile >= 0 && checkFile < 8 && rank < 7) {
-                Square frontSq = makeSquare(checkFile, rank + 1);
-                const Piece& piece = board_.pieceAt(frontSq);
-                if (piece.type() == PieceType::Pawn && piece.isWhite()) {
-                    score += 10;
-                }
+    for (int i = 0; i < 4; ++i) {
+        const MobilityCenter& mobility = MOBILITY_CENTERS[i];
+        Bitboard pieces = board_.pieces(color, mobility.type);
+        while (pieces) {
+            Square sq = popLsb(pieces);
+            Bitboard attacks;
+            switch (mobility.type) {
+                case PieceType::Knight: attacks = knightAttacks(sq); break;
+                case PieceType::Bishop: attacks = bishopAttacks(sq, occupied); break;
+                case PieceType::Rook:   attacks = rookAttacks(sq, occupied); break;
+                default:                attacks = queenAttacks(sq, occupied); break;
             }
+            add(score, params_.mobility[i], sign * (popCount(attacks & safe) - mobility.center));
         }
     }
-    
-    if (blackKing != 255 && !isEndgame()) {
-        int file = getFile(blackKing);
-        int rank = getRank(blackKing);
+}
+
+void Evaluator::evaluateKingSafety(const PawnEntry& pawns, PhaseScore& score) const {
+    // Упрощенная оценка безопасности короля: пешки перед королем и линии без
+    // своих пешек рядом с ним. В эндшпиле король должен быть активным -
+    // вклад сходит на нет с фазой.
+    for (Color color : {Color::White, Color::Black}) {
+        Square king = board_.findKing(color);
+        if (king == 255) continue;
+        
+        int sign = (color == Color::White) ? 1 : -1;
+        int forward = (color == Color::White) ? 1 : -1;
+        int file = getFile(king);
+        int rank = getRank(king) + forward;
+        uint8_t semiOpen = pawns.semiOpenFiles[static_cast<int>(color)];
         
         for (int df = -1; df <= 1; ++df) {
             int checkFile = file + df;
-            if (checkFile >= 0 && checkFile < 8 && rank > 0) {
-                Square frontSq = makeSquare(checkFile, rank - 1);
-                const Piece& piece = board_.pieceAt(frontSq);
-                if (piece.type() == PieceType::Pawn && piece.isBlack()) {
-                    score -= 10;
+            if (checkFile < 0 || checkFile >= 8) continue;
+            
+            if (rank >= 0 && rank < 8) {
+                const Piece& piece = board_.pieceAt(makeSquare(checkFile, rank));
+                if (piece.type() == PieceType::Pawn && piece.color() == color) {
+                    add(score, params_.pawnShield, sign);
                 }
             }
+            if (semiOpen & (1 << checkFile)) {
+                add(score, params_.kingSemiOpenFile, sign);
+            }
         }
     }
-    
-    return score;
 }
 
-int Evaluator::evaluatePawnStructure() const {
-    int score = 0;
+void Evaluator::evaluatePieceFiles(const PawnEntry& pawns, PhaseScore& score) const {
+    using namespace Bitboards;
+    
+    uint8_t openFiles = pawns.semiOpenFiles[0] & pawns.semiOpenFiles[1];
     
-    // Проверка сдвоенных пешек
-    for (int file = 0; file < 8; ++file) {
-        int whitePawns = 0;
-        int blackPawns = 0;
+    for (Color color : {Color::White, Color::Black}) {
+        int us = static_cast<int>(color);
+        int them = static_cast<int>(oppositeColor(color));
+        int sign = (color == Color::White) ? 1 : -1;
         
-        for (int rank = 0; rank < 8; ++rank) {
-            Square sq = makeSquare(file, rank);
-            const Piece& piece = board_.pieceAt(sq);
-            
-            if (piece.type() == PieceType::Pawn) {
-                if (piece.isWhite()) whitePawns++;
-                else blackPawns++;
+        Bitboard rooks = board_.pieces(color, PieceType::Rook);
+        while (rooks) {
+            int file = getFile(popLsb(rooks));
+            if (openFiles & (1 << file)) {
+                add(score, params_.rookOpenFile, sign);
+            } else if (pawns.semiOpenFiles[us] & (1 << file)) {
+                add(score, params_.rookSemiOpenFile, sign);
             }
         }
         
-        if (whitePawns > 1) score -= 20 * (whitePawns - 1);
-        if (blackPawns > 1) score += 20 * (blackPawns - 1);
+        // Форпост: конь на половине соперника под защитой своей пешки, которого
+        // пешки соперника уже никогда не смогут прогнать
+        Bitboard outposts = board_.pieces(color, PieceType::Knight) & ENEMY_HALF[us] &
+                            pawns.attacks[us] & ~pawns.attackSpan[them];
+        add(score, params_.knightOutpost, sign * popCount(outposts));
+    }
+}
+
+const PawnEntry& Evaluator::probePawns(PawnEntry& local) const {
+    uint64_t key = board_.pawnKey();
+    // При трассировке кеш не используется: нужны коэффициенты, а не сумма
+    bool cached = pawnTable_ && !trace_;
+    PawnEntry& entry = cached ? pawnTable_->slot(key) : local;
+    if (!cached || entry.key != key) {
+        evaluatePawnStructure(entry);
+        entry.key = key;
     }
+    return entry;
+}
+
+void Evaluator::evaluatePawnStructure(PawnEntry& entry) const {
+    using namespace Bitboards;
     
-    // Проверка изолированных пешек
-    for (int file = 0; file < 8; ++file) {
-        bool hasWhitePawn = false;
-        bool hasBlackPawn = false;
-        bool hasAdjacentWhite = false;
-        bool hasAdjacentBlack = false;
+    Bitboard pawnsByColor[2] = {
+        board_.pieces(Color::White, PieceType::Pawn),
+        board_.pieces(Color::Black, PieceType::Pawn)
+    };
+    
+    // Клетки перед пешками (на своей и соседних вертикалях) - то, что
+    // мешает проходу пешек соперника
+    Bitboard frontSpan[2] = {
+        northFill(pawnsByColor[0] << 8),
+        southFill(pawnsByColor[1] >> 8)
+    };
+    
+    PhaseScore score;
+    for (Color color : {Color::White, Color::Black}) {
+        int us = static_cast<int>(color);
+        int them = 1 - us;
+        int sign = (color == Color::White) ? 1 : -1;
+        Bitboard pawns = pawnsByColor[us];
+        
+        entry.attacks[us] = pawnAttacksBB(pawns, color);
+        entry.attackSpan[us] = (color == Color::White) ? northFill(entry.attacks[us])
+                                                       : southFill(entry.attacks[us]);
+        uint8_t files = filesOf(pawns);
+        entry.semiOpenFiles[us] = static_cast<uint8_t>(~files);
+        
+        // Проходная: перед ней нет пешек соперника ни на своей, ни на соседних
+        // вертикалях, и нет своей пешки впереди (из сдвоенных считается передняя)
+        Bitboard blockers = frontSpan[them] | shiftEast(frontSpan[them]) | shiftWest(frontSpan[them]);
+        entry.passed[us] = pawns & ~blockers & ~frontSpan[us];
         
-        for (int rank = 0; rank < 8; ++rank) {
-            Square sq = makeSquare(file, rank);
-            const Piece& piece = board_.pieceAt(sq);
+        for (int file = 0; file < 8; ++file) {
+            Bitboard onFile = pawns & fileBB(file);
+            if (!onFile) continue;
             
-            if (piece.type() == PieceType::Pawn) {
-                if (piece.isWhite()) hasWhitePawn = true;
-                else hasBlackPawn = true;
+            // Сдвоенные
+            int count = popCount(onFile);
+            if (count > 1) {
+                add(score, params_.doubledPawn, sign * (count - 1));
             }
             
-            // Проверка соседних вертикалей
-            for (int df : {-1, 1}) {
-                int adjFile = file + df;
-                if (adjFile >= 0 && adjFile < 8) {
-                    Square adjSq = makeSquare(adjFile, rank);
-                    const Piece& adjPiece = board_.pieceAt(adjSq);
-                    
-                    if (adjPiece.type() == PieceType::Pawn) {
-                        if (adjPiece.isWhite()) hasAdjacentWhite = true;
-                        else hasAdjacentBlack = true;
-                    }
-                }
+            // Изолированная вертикаль: рядом нет своих пешек
+            uint8_t adjacent = static_cast<uint8_t>(((1 << file) << 1) | ((1 << file) >> 1));
+            if (!(files & adjacent)) {
+                add(score, params_.isolatedPawn, sign);
             }
         }
         
-        if (hasWhitePawn && !hasAdjacentWhite) score -= 15;
-        if (hasBlackPawn && !hasAdjacentBlack) score += 15;
-    }
-    
-    return score;
-}
-
-bool Evaluator::isEndgame() const {
-    int totalMaterial = 0;
-    
-    for (Square sq = 0; sq < NUM_SQUARES; ++sq) {
-        const Piece& piece = board_.pieceAt(sq);
-        if (!piece.isNone() && piece.type() != PieceType::King && piece.type() != PieceType::Pawn) {
-            totalMaterial += piece.value();
+        Bitboard passed = entry.passed[us];
+        while (passed) {
+            int rank = getRank(popLsb(passed));
+            int relativeRank = (color == Color::White) ? rank : 7 - rank;
+            add(score, params_.passedPawn[relativeRank], sign);
         }
     }
     
-    // Эндшпиль, если материала меньше 2600 (примерно 2 ладьи + конь/слон)
-    return totalMaterial < 2600;
+    entry.mg = static_cast<int16_t>(score.mg);
+    entry.eg = static_cast<int16_t>(score.eg);
 }
 
 }} // namespace Chess::AI
-
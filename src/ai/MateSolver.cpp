@@ -0,0 +1,290 @@
+#include "ai/MateSolver.h"
+#include "ai/ThreadPlacement.h"
+#include "core/MoveGenerator.h"
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <string>
+
+namespace Chess {
+namespace AI {
+
+// Позиции в таблице хранят монотонный факт "мат не позже чем за depth ходов":
+// Lower - мат есть (верно и для большей глубины), Upper - мата нет (верно и
+// для меньшей). Правило 50 ходов и повторения для коротких матов не учитываются.
+namespace {
+
+bool probeMate(const TranspositionTable& tt, uint64_t key, int movesLeft, bool& result) {
+    TTEntry entry;
+    if (!tt.probe(key, entry)) {
+        return false;
+    }
+    if (entry.bound == Bound::Lower && entry.depth <= movesLeft) {
+        result = true;
+        return true;
+    }
+    if (entry.bound == Bound::Upper && entry.depth >= movesLeft) {
+        result = false;
+        return true;
+    }
+    return false;
+}
+
+bool capturesFirst(const Move& a, const Move& b) {
+    return (a.isCapture() || a.isPromotion()) > (b.isCapture() || b.isPromotion());
+}
+
+} // namespace
+
+MateSolver::MateSolver(size_t hashMb) : tt_(hashMb) {}
+
+MateSolverResult MateSolver::solve(const Board& board, int maxMoves) {
+    auto startTime = std::chrono::high_resolution_clock::now();
+    shouldStop_ = false;
+    nodes_ = 0;
+    tt_.clear();
+
+    MateSolverResult result;
+    std::string fen = board.toFEN();
+    Board root;
+    root.setFromFEN(fen);
+    Color attacker = root.position().sideToMove();
+    std::vector<Move> moves = attackerMoves(root, attacker);
+    std::vector<Move> mating;
+
+    for (int n = 1; n <= maxMoves && mating.empty() && !shouldStop_; ++n) {
+        // На глубине n проверяются все ходы корня без раннего выхода:
+        // это и есть доказательство единственности ключевого хода
+        std::vector<char> wins = rootWins(fen, moves, attacker, n);
+        if (shouldStop_) {
+            break;
+        }
+        for (size_t i = 0; i < moves.size(); ++i) {
+            if (wins[i]) {
+                mating.push_back(moves[i]);
+            }
+        }
+        if (!mating.empty()) {
+            result.mateIn = n;
+        }
+    }
+    if (mating.empty() || shouldStop_) {
+        auto endTime = std::chrono::high_resolution_clock::now();
+        result.nodes = nodes_.load();
+        result.timeSpent = std::chrono::duration<double>(endTime - startTime).count();
+        return result;
+    }
+    result.found = true;
+
+    // Вариант строится заново: первым найдется тот же ключевой ход
+    uint64_t localNodes = 0;
+    buildLine(root, attacker, result.mateIn, result.line, localNodes);
+    nodes_ += localNodes;
+    result.alternatives.assign(mating.begin() + 1, mating.end());
+    bool proven = true;
+
+    if (checksOnly_) {
+        // Перебор одних шахов не доказывает, что остальные ходы не матуют:
+        // тихий первый ход или тихое продолжение перебор не видел. Все ходы
+        // корня, кроме уже матующих, проверяются полным перебором на той же
+        // глубине. Позиции "мата нет" в таблице - только для шахов, ее очищаем.
+        tt_.clear();
+        checksOnly_ = false;
+        std::vector<Move> others;
+        for (const Move& move : attackerMoves(root, attacker)) {
+            if (std::find(mating.begin(), mating.end(), move) == mating.end()) {
+                others.push_back(move);
+            }
+        }
+        std::vector<char> wins = rootWins(fen, others, attacker, result.mateIn);
+        checksOnly_ = true;
+        proven = !shouldStop_;
+        for (size_t i = 0; proven && i < others.size(); ++i) {
+            if (wins[i]) {
+                result.alternatives.push_back(others[i]);
+            }
+        }
+    }
+    result.unique = proven && result.alternatives.empty();
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    result.nodes = nodes_.load();
+    result.timeSpent = std::chrono::duration<double>(endTime - startTime).count();
+    return result;
+}
+
+std::vector<char> MateSolver::rootWins(const std::string& fen, const std::vector<Move>& moves,
+                                       Color attacker, int n) {
+    std::vector<char> wins(moves.size(), 0);
+    std::atomic<size_t> nextMove(0);
+
+    auto worker = [this, &fen, &moves, &wins, &nextMove, attacker, n](int threadIndex) {
+        // Вызывающий поток (threadIndex 0) не закрепляем - он не наш
+        if (threadIndex > 0) {
+            pinCurrentThread(threadIndex);
+        }
+        Board boardCopy;
+        boardCopy.setFromFEN(fen);
+        uint64_t localNodes = 0;
+        for (size_t i = nextMove++; i < moves.size() && !shouldStop_; i = nextMove++) {
+            boardCopy.makeMove(moves[i]);
+            wins[i] = defend(boardCopy, attacker, n - 1, localNodes) ? 1 : 0;
+            boardCopy.unmakeMove(moves[i]);
+        }
+        nodes_ += localNodes;
+    };
+
+    std::vector<std::future<void>> futures;
+    for (int t = 1; t < threads_; ++t) {
+        futures.push_back(std::async(std::launch::async, worker, t));
+    }
+    worker(0);
+    for (auto& future : futures) {
+        future.get();
+    }
+    return wins;
+}
+
+std::vector<Move> MateSolver::attackerMoves(Board& board, Color attacker) const {
+    MoveGenerator generator(board);
+    std::vector<Move> moves = generator.generateLegalMoves(attacker);
+    std::stable_sort(moves.begin(), moves.end(), capturesFirst);
+
+    if (!checksOnly_) {
+        return moves;
+    }
+    Color defender = oppositeColor(attacker);
+    std::vector<Move> checks;
+    for (const Move& move : moves) {
+        board.makeMove(move);
+        if (board.isCheck(defender)) {
+            checks.push_back(move);
+        }
+        board.unmakeMove(move);
+    }
+    return checks;
+}
+
+bool MateSolver::attack(Board& board, Color attacker, int movesLeft, uint64_t& nodes) {
+    nodes++;
+    if (movesLeft <= 0 || shouldStop_) {
+        return false;
+    }
+
+    uint64_t key = board.hash();
+    bool cached;
+    if (probeMate(tt_, key, movesLeft, cached)) {
+        return cached;
+    }
+
+    Color defender = oppositeColor(attacker);
+    bool mates = false;
+    Move mateMove;
+    for (const Move& move : attackerMoves(board, attacker)) {
+        board.makeMove(move);
+        // Последним ходом матуют только шахом - остальное можно не смотреть
+        bool candidate = movesLeft > 1 || board.isCheck(defender);
+        mates = candidate && defend(board, attacker, movesLeft - 1, nodes);
+        board.unmakeMove(move);
+        if (mates) {
+            mateMove = move;
+            break;
+        }
+    }
+
+    if (!shouldStop_) {
+        tt_.store(key, mateMove, mates ? 1 : 0, movesLeft, mates ? Bound::Lower : Bound::Upper);
+    }
+    return mates;
+}
+
+bool MateSolver::defend(Board& board, Color attacker, int movesLeft, uint64_t& nodes) {
+    nodes++;
+    Color defender = oppositeColor(attacker);
+
+    MoveGenerator generator(board);
+    std::vector<Move> replies = generator.generateLegalMoves(defender);
+    if (replies.empty()) {
+        return board.isCheck(defender);  // Мат; пат - не победа
+    }
+    if (movesLeft <= 0 || shouldStop_) {
+        return false;
+    }
+
+    uint64_t key = board.hash();
+    bool cached;
+    if (probeMate(tt_, key, movesLeft, cached)) {
+        return cached;
+    }
+
+    // Взятия чаще опровергают атаку - пробуем их первыми
+    std::stable_sort(replies.begin(), replies.end(), capturesFirst);
+    bool mated = true;
+    Move refutation;
+    for (const Move& reply : replies) {
+        board.makeMove(reply);
+        bool lost = attack(board, attacker, movesLeft, nodes);
+        board.unmakeMove(reply);
+        if (!lost) {
+            mated = false;
+            refutation = reply;
+            break;
+        }
+    }
+
+    if (!shouldStop_) {
+        tt_.store(key, refutation, mated ? 1 : 0, movesLeft, mated ? Bound::Lower : Bound::Upper);
+    }
+    return mated;
+}
+
+int MateSolver::mateDistance(Board& board, Color attacker, int maxMoves, uint64_t& nodes) {
+    for (int n = 1; n <= maxMoves; ++n) {
+        if (attack(board, attacker, n, nodes)) {
+            return n;
+        }
+    }
+    return 0;
+}
+
+void MateSolver::buildLine(Board& board, Color attacker, int mateIn, std::vector<Move>& line,
+                           uint64_t& nodes) {
+    if (mateIn <= 0 || shouldStop_) {
+        return;
+    }
+    Color defender = oppositeColor(attacker);
+
+    for (const Move& move : attackerMoves(board, attacker)) {
+        board.makeMove(move);
+        if (!defend(board, attacker, mateIn - 1, nodes)) {
+            board.unmakeMove(move);
+            continue;
+        }
+        line.push_back(move);
+
+        // Защищающийся выбирает ответ, дольше всех оттягивающий мат
+        MoveGenerator generator(board);
+        std::vector<Move> replies = generator.generateLegalMoves(defender);
+        if (!replies.empty()) {
+            Move longestReply = replies[0];
+            int longest = -1;
+            for (const Move& reply : replies) {
+                board.makeMove(reply);
+                int distance = mateDistance(board, attacker, mateIn - 1, nodes);
+                board.unmakeMove(reply);
+                if (distance > longest) {
+                    longest = distance;
+                    longestReply = reply;
+                }
+            }
+            line.push_back(longestReply);
+            board.makeMove(longestReply);
+            buildLine(board, attacker, longest, line, nodes);
+            board.unmakeMove(longestReply);
+        }
+        board.unmakeMove(move);
+        return;
+    }
+}
+
+}} // namespace Chess::AI
@@ -0,0 +1,354 @@
+#include "ai/MctsEngine.h"
+#include "ai/Score.h"
+#include "ai/ThreadPlacement.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <future>
+
+namespace Chess {
+namespace AI {
+
+namespace {
+
+constexpr int MAX_PATH_LENGTH = 256;
+constexpr int MAX_SCORE_CP = 3000;
+
+// Оценка в сантипешках <-> ожидаемый результат в [-1, 1] (шкала Эло)
+float centipawnsToValue(int cp) {
+    return 2.0f / (1.0f + std::pow(10.0f, -cp / 400.0f)) - 1.0f;
+}
+
+int valueToCentipawns(float value) {
+    value = std::max(-0.999f, std::min(0.999f, value));
+    int cp = static_cast<int>(std::lround(400.0f * std::log10((1.0f + value) / (1.0f - value))));
+    return std::max(-MAX_SCORE_CP, std::min(MAX_SCORE_CP, cp));
+}
+
+} // namespace
+
+MctsEngine::MctsEngine(Board& board) : board_(board) {}
+
+void MctsEngine::setParams(const MctsParams& params) {
+    bool resize = params.poolSizeMb != params_.poolSizeMb;
+    params_ = params;
+    if (resize) {
+        pool_.reset();
+        rootFen_.clear();
+    }
+}
+
+void MctsEngine::clearTree() {
+    rootFen_.clear();
+}
+
+void MctsEngine::allocatePool() {
+    poolCapacity_ = static_cast<uint32_t>(std::max<size_t>(
+        params_.poolSizeMb * 1024 * 1024 / sizeof(Node), 1024));
+    pool_ = std::make_unique<Node[]>(poolCapacity_);
+}
+
+uint32_t MctsEngine::allocateNodes(uint32_t count) {
+    uint32_t first = poolUsed_.fetch_add(count);
+    if (first + count > poolCapacity_) {
+        return 0;
+    }
+    for (uint32_t i = first; i < first + count; ++i) {
+        Node& node = pool_[i];
+        node.move = Move();
+        node.prior = 0.0f;
+        node.visits = 0;
+        node.virtualLoss = 0;
+        node.valueSum = 0;
+        node.firstChild = 0;
+        node.childCount = 0;
+        node.terminalValue = 0;
+        node.state = Unexpanded;
+    }
+    return first;
+}
+
+void MctsEngine::resetTree() {
+    poolUsed_ = 1;  // Индекс 0 зарезервирован как "нет узла"
+    root_ = allocateNodes(1);
+}
+
+bool MctsEngine::reuseTree() {
+    // Старое дерево без корня или пул заполнен наполовину - проще начать заново
+    if (rootFen_.empty() || poolUsed_.load() > poolCapacity_ / 2) {
+        return false;
+    }
+    const Node& root = pool_[root_];
+    uint64_t target = board_.hash();
+
+    Board old;
+    old.setFromFEN(rootFen_);
+    if (old.hash() == target) {
+        return true;
+    }
+    if (root.state.load() != Expanded) {
+        return false;
+    }
+
+    // Свой ход и ответ соперника: новый корень - внук старого
+    for (uint32_t i = root.firstChild; i < root.firstChild + root.childCount; ++i) {
+        const Node& child = pool_[i];
+        old.makeMove(child.move);
+        if (old.hash() == target) {
+            root_ = i;
+            return true;
+        }
+        if (child.state.load() == Expanded) {
+            for (uint32_t j = child.firstChild; j < child.firstChild + child.childCount; ++j) {
+                old.makeMove(pool_[j].move);
+                bool found = old.hash() == target;
+                old.unmakeMove(pool_[j].move);
+                if (found) {
+                    root_ = j;
+                    return true;
+                }
+            }
+        }
+        old.unmakeMove(child.move);
+    }
+    return false;
+}
+
+SearchResult MctsEngine::findBestMove(Color /*color*/, int simulations) {
+    return search(simulations, 0);
+}
+
+SearchResult MctsEngine::findBestMoveWithTimeLimit(Color /*color*/, int timeMs) {
+    return search(0, timeMs);
+}
+
+SearchResult MctsEngine::search(int simulations, int timeMs) {
+    auto startTime = std::chrono::steady_clock::now();
+    shouldStop_ = false;
+    maxPathLength_ = 0;
+
+    if (!pool_) {
+        allocatePool();
+        rootFen_.clear();
+    }
+    if (!params_.reuseTree || !reuseTree()) {
+        resetTree();
+    }
+    std::string fen = board_.toFEN();
+    rootFen_ = fen;
+    int visitsBefore = pool_[root_].visits.load();
+
+    // Quiescence не обращается к таблице транспозиций - одной маленькой хватит всем
+    auto sharedTable = std::make_shared<TranspositionTable>(1);
+    auto sharedEvalCache = std::make_shared<EvalCache>();
+    std::atomic<int> simulationsStarted(0);
+
+    auto worker = [&](int threadIndex) {
+        // Вызывающий поток (threadIndex 0) не закрепляем - он не наш
+        if (threadIndex > 0) {
+            pinCurrentThread(threadIndex);
+        }
+        Board board;
+        board.setFromFEN(fen);
+        Engine evaluator(board, sharedTable, sharedEvalCache);
+        evaluator.setLogFile("");
+
+        while (!shouldStop_) {
+            if (simulations > 0 && simulationsStarted.fetch_add(1) >= simulations) {
+                break;
+            }
+            if (timeMs > 0) {
+                auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now() - startTime).count();
+                if (elapsed >= timeMs) {
+                    break;
+                }
+            }
+            if (poolUsed_.load(std::memory_order_relaxed) >= poolCapacity_) {
+                break;  // Дерево больше не растет
+            }
+            runSimulation(board, evaluator);
+        }
+    };
+
+    std::vector<std::future<void>> futures;
+    for (int t = 1; t < params_.threads; ++t) {
+        futures.push_back(std::async(std::launch::async, worker, t));
+    }
+    worker(0);
+    for (auto& future : futures) {
+        future.get();
+    }
+
+    // Лучший ход - самый посещаемый (устойчивее, чем максимальный Q)
+    const Node& root = pool_[root_];
+    SearchResult result{Move(), 0, 0, 0, 0.0, SearchStats(), {}, 0, 0, 0};
+    if (root.state.load() == Expanded) {
+        int bestVisits = -1;
+        for (uint32_t i = root.firstChild; i < root.firstChild + root.childCount; ++i) {
+            int visits = pool_[i].visits.load();
+            if (visits > bestVisits) {
+                bestVisits = visits;
+                result.bestMove = pool_[i].move;
+                // Ход, сразу ставящий мат, - терминальный узел с поражением соперника
+                bool mates = pool_[i].state.load() == Terminal && pool_[i].terminalValue < 0;
+                result.score = mates ? mateIn(1) : valueToCentipawns(nodeQ(pool_[i]));
+            }
+        }
+    }
+    result.pv = principalVariation();
+    result.depth = static_cast<int>(result.pv.size());
+    result.selDepth = std::max(0, maxPathLength_.load() - 1);
+    result.nodesSearched = root.visits.load() - visitsBefore;
+    result.mainNodes = result.nodesSearched;
+    result.timeSpent = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    return result;
+}
+
+void MctsEngine::runSimulation(Board& board, Engine& evaluator) {
+    uint32_t path[MAX_PATH_LENGTH];
+    int length = 0;
+
+    // Спуск по PUCT; виртуальное поражение уводит другие потоки на соседние ветви
+    uint32_t index = root_;
+    path[length++] = index;
+    while (pool_[index].state.load(std::memory_order_acquire) == Expanded && length < MAX_PATH_LENGTH) {
+        index = selectChild(pool_[index]);
+        Node& child = pool_[index];
+        child.virtualLoss.fetch_add(params_.virtualLoss, std::memory_order_relaxed);
+        board.makeMove(child.move);
+        path[length++] = index;
+    }
+
+    // Значение листа - для стороны, которая в нем ходит
+    Node& leaf = pool_[index];
+    float value;
+    uint8_t expected = Unexpanded;
+    if (leaf.state.load(std::memory_order_acquire) == Terminal) {
+        value = leaf.terminalValue;
+    } else if (leaf.state.compare_exchange_strong(expected, Expanding)) {
+        value = expand(leaf, board, evaluator);
+    } else {
+        value = evaluateLeaf(board, evaluator);  // Лист раскрывает другой поток
+    }
+
+    int current = maxPathLength_.load(std::memory_order_relaxed);
+    while (length > current && !maxPathLength_.compare_exchange_weak(current, length)) {
+    }
+
+    // Обратный проход: в узле хранится значение для стороны, сделавшей ход в него
+    for (int i = length - 1; i >= 0; --i) {
+        Node& node = pool_[path[i]];
+        value = -value;
+        node.valueSum.fetch_add(static_cast<int64_t>(value * VALUE_SCALE), std::memory_order_relaxed);
+        node.visits.fetch_add(1, std::memory_order_relaxed);
+        if (i > 0) {
+            node.virtualLoss.fetch_sub(params_.virtualLoss, std::memory_order_relaxed);
+            board.unmakeMove(node.move);
+        }
+    }
+}
+
+uint32_t MctsEngine::selectChild(const Node& node) const {
+    float sqrtParent = std::sqrt(static_cast<float>(std::max(1, node.visits.load(std::memory_order_relaxed))));
+    // Q узла - с точки зрения соперника выбирающей стороны
+    float fpu = -nodeQ(node) - params_.fpuReduction;
+
+    uint32_t best = node.firstChild;
+    float bestScore = -1e9f;
+    for (uint32_t i = node.firstChild; i < node.firstChild + node.childCount; ++i) {
+        const Node& child = pool_[i];
+        int visits = child.visits.load(std::memory_order_relaxed);
+        int virtualLoss = child.virtualLoss.load(std::memory_order_relaxed);
+        int effectiveVisits = visits + virtualLoss;
+
+        float q = fpu;
+        if (effectiveVisits > 0) {
+            float valueSum = static_cast<float>(child.valueSum.load(std::memory_order_relaxed)) / VALUE_SCALE;
+            q = (valueSum - virtualLoss) / effectiveVisits;
+        }
+        float score = q + params_.cpuct * child.prior * sqrtParent / (1 + effectiveVisits);
+        if (score > bestScore) {
+            bestScore = score;
+            best = i;
+        }
+    }
+    return best;
+}
+
+float MctsEngine::expand(Node& node, Board& board, Engine& evaluator) {
+    Color side = board.position().sideToMove();
+
+    if (board.isDraw()) {
+        node.terminalValue = 0;
+        node.state.store(Terminal, std::memory_order_release);
+        return 0.0f;
+    }
+
+    std::vector<Move> moves = evaluator.orderedMoves(side);
+    if (moves.empty()) {
+        node.terminalValue = board.isCheck(side) ? -1 : 0;  // Мат или пат
+        node.state.store(Terminal, std::memory_order_release);
+        return node.terminalValue;
+    }
+
+    uint32_t first = allocateNodes(static_cast<uint32_t>(moves.size()));
+    if (first == 0) {
+        node.state.store(Unexpanded, std::memory_order_release);
+        return evaluateLeaf(board, evaluator);
+    }
+
+    // Априорные вероятности по месту в упорядочивании: p(i) ~ 1 / (i + 1)
+    float norm = 0.0f;
+    for (size_t i = 0; i < moves.size(); ++i) {
+        norm += 1.0f / static_cast<float>(i + 1);
+    }
+    for (size_t i = 0; i < moves.size(); ++i) {
+        Node& child = pool_[first + i];
+        child.move = moves[i];
+        child.prior = 1.0f / static_cast<float>(i + 1) / norm;
+    }
+
+    float value = evaluateLeaf(board, evaluator);
+    node.firstChild = first;
+    node.childCount = static_cast<uint16_t>(moves.size());
+    node.state.store(Expanded, std::memory_order_release);
+    return value;
+}
+
+float MctsEngine::evaluateLeaf(Board& board, Engine& evaluator) const {
+    return centipawnsToValue(evaluator.quiescenceScore(board.position().sideToMove()));
+}
+
+std::vector<Move> MctsEngine::principalVariation() const {
+    std::vector<Move> pv;
+    uint32_t index = root_;
+    while (pool_[index].state.load() == Expanded && pv.size() < MAX_PATH_LENGTH) {
+        const Node& node = pool_[index];
+        uint32_t best = 0;
+        int bestVisits = 0;
+        for (uint32_t i = node.firstChild; i < node.firstChild + node.childCount; ++i) {
+            int visits = pool_[i].visits.load();
+            if (visits > bestVisits) {
+                bestVisits = visits;
+                best = i;
+            }
+        }
+        if (best == 0) {
+            break;
+        }
+        pv.push_back(pool_[best].move);
+        index = best;
+    }
+    return pv;
+}
+
+float MctsEngine::nodeQ(const Node& node) {
+    int visits = node.visits.load(std::memory_order_relaxed);
+    if (visits == 0) {
+        return 0.0f;
+    }
+    return static_cast<float>(node.valueSum.load(std::memory_order_relaxed)) / VALUE_SCALE / visits;
+}
+
+}} // namespace Chess::AI
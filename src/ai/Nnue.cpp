@@ -0,0 +1,405 @@
+#include "ai/Nnue.h"
+#include "ai/Score.h"
+#include "core/Bitboards.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <random>
+
+// Векторные ядра - для x86 на GCC/Clang: каждая функция компилируется под свой
+// набор инструкций (target), а выбирается при запуске. Остальное - скалярно.
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define CHESS_NNUE_X86 1
+#include <immintrin.h>
+#endif
+
+namespace Chess {
+namespace AI {
+namespace Nnue {
+
+namespace {
+
+constexpr uint32_t FILE_MAGIC = 0x4E4E4843;     // "CHNN"
+constexpr uint32_t FILE_VERSION = 1;
+
+// acc[i] += / -= weights[i], i < L1 (int16 с переполнением по модулю - как в SIMD)
+using UpdateFn = void (*)(int16_t* acc, const int16_t* weights);
+// Скалярное произведение uint8 x int8, size кратен 32. Произведения пар
+// укладываются в int16 без насыщения (|x| <= 127), поэтому все ядра точно совпадают.
+using DotFn = int32_t (*)(const uint8_t* input, const int8_t* weights, int size);
+
+void addScalar(int16_t* acc, const int16_t* weights) {
+    for (int i = 0; i < L1; ++i) {
+        acc[i] = static_cast<int16_t>(acc[i] + weights[i]);
+    }
+}
+
+void subScalar(int16_t* acc, const int16_t* weights) {
+    for (int i = 0; i < L1; ++i) {
+        acc[i] = static_cast<int16_t>(acc[i] - weights[i]);
+    }
+}
+
+int32_t dotScalar(const uint8_t* input, const int8_t* weights, int size) {
+    int32_t sum = 0;
+    for (int i = 0; i < size; ++i) {
+        sum += static_cast<int32_t>(input[i]) * weights[i];
+    }
+    return sum;
+}
+
+#ifdef CHESS_NNUE_X86
+__attribute__((target("sse4.1")))
+void addSse41(int16_t* acc, const int16_t* weights) {
+    for (int i = 0; i < L1; i += 8) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc + i));
+        __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(acc + i), _mm_add_epi16(a, w));
+    }
+}
+
+__attribute__((target("sse4.1")))
+void subSse41(int16_t* acc, const int16_t* weights) {
+    for (int i = 0; i < L1; i += 8) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc + i));
+        __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(acc + i), _mm_sub_epi16(a, w));
+    }
+}
+
+__attribute__((target("sse4.1")))
+int32_t dotSse41(const uint8_t* input, const int8_t* weights, int size) {
+    const __m128i ones = _mm_set1_epi16(1);
+    __m128i sum = _mm_setzero_si128();
+    for (int i = 0; i < size; i += 16) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+        __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights + i));
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_maddubs_epi16(a, w), ones));
+    }
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+    return _mm_cvtsi128_si32(sum);
+}
+
+__attribute__((target("avx2")))
+void addAvx2(int16_t* acc, const int16_t* weights) {
+    for (int i = 0; i < L1; i += 16) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc + i));
+        __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc + i), _mm256_add_epi16(a, w));
+    }
+}
+
+__attribute__((target("avx2")))
+void subAvx2(int16_t* acc, const int16_t* weights) {
+    for (int i = 0; i < L1; i += 16) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc + i));
+        __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc + i), _mm256_sub_epi16(a, w));
+    }
+}
+
+__attribute__((target("avx2")))
+int32_t dotAvx2(const uint8_t* input, const int8_t* weights, int size) {
+    const __m256i ones = _mm256_set1_epi16(1);
+    __m256i sum = _mm256_setzero_si256();
+    for (int i = 0; i < size; i += 32) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i));
+        __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + i));
+        sum = _mm256_add_epi32(sum, _mm256_madd_epi16(_mm256_maddubs_epi16(a, w), ones));
+    }
+    __m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+    half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0x4E));
+    half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0xB1));
+    return _mm_cvtsi128_si32(half);
+}
+#endif
+
+struct Kernels {
+    SimdLevel level;
+    UpdateFn add;
+    UpdateFn sub;
+    DotFn dot;
+};
+
+Kernels kernelsFor(SimdLevel level) {
+#ifdef CHESS_NNUE_X86
+    switch (level) {
+        case SimdLevel::Avx2:  return {level, addAvx2, subAvx2, dotAvx2};
+        case SimdLevel::Sse41: return {level, addSse41, subSse41, dotSse41};
+        default: break;
+    }
+#endif
+    return {SimdLevel::Scalar, addScalar, subScalar, dotScalar};
+}
+
+SimdLevel detectSimdLevel() {
+#ifdef CHESS_NNUE_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return SimdLevel::Avx2;
+    if (__builtin_cpu_supports("sse4.1")) return SimdLevel::Sse41;
+#endif
+    return SimdLevel::Scalar;
+}
+
+const SimdLevel DETECTED_LEVEL = detectSimdLevel();
+Kernels kernels = kernelsFor(DETECTED_LEVEL);
+
+inline uint8_t clippedRelu(int32_t value) {
+    return static_cast<uint8_t>(std::min(std::max(value, 0), ACTIVATION_MAX));
+}
+
+// Индекс входа HalfKP. Для черных доска отражается по горизонтали, чтобы
+// сеть видела позицию "со своей стороны".
+inline int featureIndex(Color perspective, Square king, const Piece& piece, Square sq) {
+    if (perspective == Color::Black) {
+        king ^= 56;
+        sq ^= 56;
+    }
+    int pieceIndex = (static_cast<int>(piece.type()) - 1) * 2 + (piece.color() == perspective ? 0 : 1);
+    return (king * 10 + pieceIndex) * 64 + sq;
+}
+
+template <typename T>
+bool readArray(std::istream& in, std::vector<T>& values, size_t count) {
+    values.resize(count);
+    in.read(reinterpret_cast<char*>(values.data()), static_cast<std::streamsize>(count * sizeof(T)));
+    return static_cast<bool>(in);
+}
+
+template <typename T>
+void writeArray(std::ostream& out, const std::vector<T>& values) {
+    out.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(T)));
+}
+
+} // namespace
+
+SimdLevel detectedSimdLevel() {
+    return DETECTED_LEVEL;
+}
+
+SimdLevel simdLevel() {
+    return kernels.level;
+}
+
+void setSimdLevel(SimdLevel level) {
+    kernels = kernelsFor(std::min(level, DETECTED_LEVEL));
+}
+
+const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::Avx2:  return "AVX2";
+        case SimdLevel::Sse41: return "SSE4.1";
+        default:               return "scalar";
+    }
+}
+
+bool Network::load(const std::string& path, std::string& error) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        error = "не удалось открыть файл сети " + path;
+        return false;
+    }
+    
+    uint32_t header[6];
+    in.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (!in || header[0] != FILE_MAGIC) {
+        error = path + ": не файл сети";
+        return false;
+    }
+    if (header[1] != FILE_VERSION || header[2] != FEATURES || header[3] != L1 ||
+        header[4] != L2 || header[5] != L3) {
+        error = path + ": другая версия или архитектура сети";
+        return false;
+    }
+    
+    bool ok = readArray(in, featureWeights, static_cast<size_t>(FEATURES) * L1) &&
+              readArray(in, featureBias, L1) &&
+              readArray(in, hidden1Weights, L2 * 2 * L1) &&
+              readArray(in, hidden1Bias, L2) &&
+              readArray(in, hidden2Weights, L3 * L2) &&
+              readArray(in, hidden2Bias, L3) &&
+              readArray(in, outputWeights, L3);
+    in.read(reinterpret_cast<char*>(&outputBias), sizeof(outputBias));
+    if (!ok || !in || in.peek() != std::char_traits<char>::eof()) {
+        error = path + ": файл сети поврежден (неверный размер)";
+        return false;
+    }
+    return true;
+}
+
+bool Network::save(const std::string& path, std::string& error) const {
+    std::ofstream out(path, std::ios::binary);
+    if (!out.is_open()) {
+        error = "не удалось создать файл сети " + path;
+        return false;
+    }
+    const uint32_t header[6] = {FILE_MAGIC, FILE_VERSION, FEATURES, L1, L2, L3};
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    writeArray(out, featureWeights);
+    writeArray(out, featureBias);
+    writeArray(out, hidden1Weights);
+    writeArray(out, hidden1Bias);
+    writeArray(out, hidden2Weights);
+    writeArray(out, hidden2Bias);
+    writeArray(out, outputWeights);
+    out.write(reinterpret_cast<const char*>(&outputBias), sizeof(outputBias));
+    if (!out) {
+        error = "ошибка записи файла сети " + path;
+        return false;
+    }
+    return true;
+}
+
+std::shared_ptr<Network> Network::makeRandom(uint32_t seed) {
+    std::mt19937 rng(seed);
+    auto fill = [&rng](auto& values, size_t count, int low, int high) {
+        std::uniform_int_distribution<int> dist(low, high);
+        values.resize(count);
+        for (auto& value : values) {
+            value = static_cast<typename std::decay_t<decltype(values)>::value_type>(dist(rng));
+        }
+    };
+    
+    auto network = std::make_shared<Network>();
+    fill(network->featureWeights, static_cast<size_t>(FEATURES) * L1, -16, 16);
+    fill(network->featureBias, L1, 0, 64);
+    fill(network->hidden1Weights, L2 * 2 * L1, -32, 32);
+    fill(network->hidden1Bias, L2, -2048, 2048);
+    fill(network->hidden2Weights, L3 * L2, -64, 64);
+    fill(network->hidden2Bias, L3, -2048, 2048);
+    fill(network->outputWeights, L3, -127, 127);
+    network->outputBias = 0;
+    return network;
+}
+
+Accumulator::Accumulator(std::shared_ptr<const Network> network) : network_(std::move(network)) {
+    stack_.reserve(256);
+    stack_.emplace_back();
+    stack_.back().dirty[0] = stack_.back().dirty[1] = true;
+}
+
+Accumulator::~Accumulator() {
+    detach();
+}
+
+void Accumulator::attach(Board& board) {
+    detach();
+    board_ = &board;
+    board.setObserver(this);
+    onReset(board);
+}
+
+void Accumulator::detach() {
+    if (board_ && board_->observer() == this) {
+        board_->setObserver(nullptr);
+    }
+    board_ = nullptr;
+}
+
+void Accumulator::onMakeMove() {
+    stack_.push_back(stack_.back());
+}
+
+void Accumulator::onPieceChanged(Square sq, const Piece& removed, const Piece& added) {
+    State& state = stack_.back();
+    for (Color perspective : {Color::White, Color::Black}) {
+        int p = static_cast<int>(perspective);
+        if (state.dirty[p]) continue;
+        
+        // Свой король сдвинулся - все входы перспективы другие
+        if ((removed.type() == PieceType::King && removed.color() == perspective) ||
+            (added.type() == PieceType::King && added.color() == perspective)) {
+            state.dirty[p] = true;
+            continue;
+        }
+        
+        Square king = board_->findKing(perspective);
+        if (king == 255) {
+            state.dirty[p] = true;
+            continue;
+        }
+        if (!removed.isNone() && removed.type() != PieceType::King) {
+            kernels.sub(state.values[p], &network_->featureWeights[
+                static_cast<size_t>(featureIndex(perspective, king, removed, sq)) * L1]);
+        }
+        if (!added.isNone() && added.type() != PieceType::King) {
+            kernels.add(state.values[p], &network_->featureWeights[
+                static_cast<size_t>(featureIndex(perspective, king, added, sq)) * L1]);
+        }
+    }
+}
+
+void Accumulator::onUnmakeMove() {
+    if (stack_.size() > 1) {
+        stack_.pop_back();
+    }
+}
+
+void Accumulator::onReset(const Board&) {
+    stack_.resize(1);
+    stack_.back().dirty[0] = stack_.back().dirty[1] = true;
+}
+
+void Accumulator::refresh(const Network& network, const Board& board, State& state, Color perspective) {
+    int p = static_cast<int>(perspective);
+    std::copy(network.featureBias.begin(), network.featureBias.end(), state.values[p]);
+    state.dirty[p] = false;
+    
+    Square king = board.findKing(perspective);
+    if (king == 255) return;
+    
+    Bitboard pieces = board.occupied() & ~(board.pieces(Color::White, PieceType::King) |
+                                           board.pieces(Color::Black, PieceType::King));
+    while (pieces) {
+        Square sq = Bitboards::popLsb(pieces);
+        kernels.add(state.values[p], &network.featureWeights[
+            static_cast<size_t>(featureIndex(perspective, king, board.pieceAt(sq), sq)) * L1]);
+    }
+}
+
+int Accumulator::evaluate(Color sideToMove) {
+    State& state = stack_.back();
+    for (Color perspective : {Color::White, Color::Black}) {
+        if (state.dirty[static_cast<int>(perspective)]) {
+            refresh(*network_, *board_, state, perspective);
+        }
+    }
+    return output(*network_, state.values[static_cast<int>(sideToMove)],
+                  state.values[static_cast<int>(oppositeColor(sideToMove))]);
+}
+
+int Accumulator::evaluateFull(const Network& network, const Board& board) {
+    State state;
+    refresh(network, board, state, Color::White);
+    refresh(network, board, state, Color::Black);
+    Color side = board.position().sideToMove();
+    return output(network, state.values[static_cast<int>(side)],
+                  state.values[static_cast<int>(oppositeColor(side))]);
+}
+
+int Accumulator::output(const Network& network, const int16_t* us, const int16_t* them) {
+    alignas(32) uint8_t input[2 * L1];
+    for (int i = 0; i < L1; ++i) {
+        input[i] = clippedRelu(us[i]);
+        input[L1 + i] = clippedRelu(them[i]);
+    }
+    
+    alignas(32) uint8_t hidden1[L2];
+    for (int o = 0; o < L2; ++o) {
+        int32_t sum = network.hidden1Bias[o] + kernels.dot(input, &network.hidden1Weights[o * 2 * L1], 2 * L1);
+        hidden1[o] = clippedRelu(sum >> WEIGHT_SHIFT);
+    }
+    
+    alignas(32) uint8_t hidden2[L3];
+    for (int o = 0; o < L3; ++o) {
+        int32_t sum = network.hidden2Bias[o] + kernels.dot(hidden1, &network.hidden2Weights[o * L2], L2);
+        hidden2[o] = clippedRelu(sum >> WEIGHT_SHIFT);
+    }
+    
+    int32_t result = network.outputBias + kernels.dot(hidden2, network.outputWeights.data(), L3);
+    // Оценка сети не должна выглядеть как мат
+    return std::min(std::max(result / OUTPUT_SCALE, -SCORE_MATE_BOUND + 1), SCORE_MATE_BOUND - 1);
+}
+
+}}} // namespace Chess::AI::Nnue
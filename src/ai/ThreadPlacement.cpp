@@ -0,0 +1,185 @@
+#include "ai/ThreadPlacement.h"
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace Chess {
+namespace AI {
+
+namespace {
+
+std::atomic<AffinityPolicy> g_policy{AffinityPolicy::None};
+
+#ifdef __linux__
+// Список CPU в формате ядра: "0-3,8,10-11"
+std::vector<int> parseCpuList(const std::string& text) {
+    std::vector<int> cpus;
+    std::stringstream ss(text);
+    std::string range;
+    while (std::getline(ss, range, ',')) {
+        size_t dash = range.find('-');
+        try {
+            int first = std::stoi(range.substr(0, dash));
+            int last = (dash == std::string::npos) ? first : std::stoi(range.substr(dash + 1));
+            for (int cpu = first; cpu <= last; ++cpu) {
+                cpus.push_back(cpu);
+            }
+        } catch (...) {
+            // Пустая строка или мусор - пропускаем
+        }
+    }
+    return cpus;
+}
+
+bool pinToCpu(int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+#endif
+
+CpuTopology detectTopology() {
+    CpuTopology topology;
+#ifdef __linux__
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    bool haveMask = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+
+    for (int node = 0;; ++node) {
+        std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        if (!file.is_open()) {
+            break;
+        }
+        std::string line;
+        std::getline(file, line);
+        std::vector<int> cpus;
+        for (int cpu : parseCpuList(line)) {
+            if (!haveMask || CPU_ISSET(cpu, &allowed)) {
+                cpus.push_back(cpu);
+            }
+        }
+        if (!cpus.empty()) {
+            topology.nodes.push_back(cpus);
+        }
+    }
+
+    if (topology.nodes.empty() && haveMask) {
+        std::vector<int> cpus;
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &allowed)) {
+                cpus.push_back(cpu);
+            }
+        }
+        topology.nodes.push_back(cpus);
+    }
+#endif
+    if (topology.nodes.empty()) {
+        std::vector<int> cpus;
+        int count = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        for (int cpu = 0; cpu < count; ++cpu) {
+            cpus.push_back(cpu);
+        }
+        topology.nodes.push_back(cpus);
+    }
+    return topology;
+}
+
+} // namespace
+
+int CpuTopology::cpuCount() const {
+    int count = 0;
+    for (const auto& node : nodes) {
+        count += static_cast<int>(node.size());
+    }
+    return count;
+}
+
+int CpuTopology::nodeOfCpu(int cpu) const {
+    for (size_t node = 0; node < nodes.size(); ++node) {
+        for (int c : nodes[node]) {
+            if (c == cpu) {
+                return static_cast<int>(node);
+            }
+        }
+    }
+    return -1;
+}
+
+const CpuTopology& cpuTopology() {
+    static const CpuTopology topology = detectTopology();
+    return topology;
+}
+
+void setAffinityPolicy(AffinityPolicy policy) {
+    g_policy = policy;
+}
+
+AffinityPolicy affinityPolicy() {
+    return g_policy;
+}
+
+const char* affinityPolicyName(AffinityPolicy policy) {
+    switch (policy) {
+        case AffinityPolicy::Compact: return "compact";
+        case AffinityPolicy::Scatter: return "scatter";
+        default: return "none";
+    }
+}
+
+int pinCurrentThread(int threadIndex) {
+    const CpuTopology& topology = cpuTopology();
+    int nodeCount = static_cast<int>(topology.nodes.size());
+
+    switch (g_policy.load()) {
+        case AffinityPolicy::Compact: {
+            int index = threadIndex % topology.cpuCount();
+            for (int node = 0; node < nodeCount; ++node) {
+                int size = static_cast<int>(topology.nodes[node].size());
+                if (index < size) {
+                    return pinCurrentThreadToNode(node, index);
+                }
+                index -= size;
+            }
+            return -1;
+        }
+        case AffinityPolicy::Scatter:
+            return pinCurrentThreadToNode(threadIndex % nodeCount, threadIndex / nodeCount);
+        default:
+            return -1;
+    }
+}
+
+int pinCurrentThreadToNode(int node, int index) {
+#ifdef __linux__
+    const CpuTopology& topology = cpuTopology();
+    if (node < 0 || node >= static_cast<int>(topology.nodes.size())) {
+        return -1;
+    }
+    const std::vector<int>& cpus = topology.nodes[node];
+    int cpu = cpus[index % cpus.size()];
+    return pinToCpu(cpu) ? cpu : -1;
+#else
+    (void)node;
+    (void)index;
+    return -1;
+#endif
+}
+
+std::string describePlacement() {
+    const CpuTopology& topology = cpuTopology();
+    std::stringstream ss;
+    ss << "политика потоков=" << affinityPolicyName(affinityPolicy())
+       << ", NUMA-узлов=" << topology.nodes.size()
+       << ", CPU=" << topology.cpuCount();
+    return ss.str();
+}
+
+}} // namespace Chess::AI
@@ -0,0 +1,178 @@
+#include "ai/TranspositionTable.h"
+#include "ai/ThreadPlacement.h"
+#include <algorithm>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace Chess {
+namespace AI {
+
+// Упаковка данных записи в 64 бита:
+//  0-5   откуда       6-11  куда        12-14 флаг хода    15-17 превращение
+//  18-33 оценка (int16)                 34-41 глубина (0-255)
+//  42-43 тип оценки   44-49 поколение
+namespace {
+
+constexpr int SCORE_SHIFT = 18;
+constexpr int DEPTH_SHIFT = 34;
+constexpr int BOUND_SHIFT = 42;
+constexpr int GENERATION_SHIFT = 44;
+
+// Очистка кусками по 2 МБ (размер большой страницы), куски чередуются по NUMA-узлам
+constexpr size_t CLEAR_CHUNK_BYTES = 2 * 1024 * 1024;
+constexpr int MAX_CLEAR_THREADS = 4;
+
+} // namespace
+
+TranspositionTable::TranspositionTable(size_t sizeMb) {
+    resize(sizeMb);
+}
+
+void TranspositionTable::resize(size_t sizeMb) {
+    // Число записей - степень двойки, чтобы индекс брался маской
+    size_t bytes = std::max<size_t>(sizeMb, 1) * 1024 * 1024;
+    size_t count = 1;
+    while (count * 2 * sizeof(Slot) <= bytes) {
+        count *= 2;
+    }
+    
+    slots_.reset(new Slot[count]);
+    mask_ = count - 1;
+    sizeMb_ = sizeMb;
+    clear();
+}
+
+void TranspositionTable::clear() {
+    generation_ = 0;
+    size_t count = mask_ + 1;
+    size_t chunk = std::max<size_t>(CLEAR_CHUNK_BYTES / sizeof(Slot), 1);
+    size_t chunks = (count + chunk - 1) / chunk;
+    
+    auto clearChunk = [this, count, chunk](size_t c) {
+        size_t end = std::min(count, (c + 1) * chunk);
+        for (size_t i = c * chunk; i < end; ++i) {
+            slots_[i].keyXorData.store(0, std::memory_order_relaxed);
+            slots_[i].data.store(0, std::memory_order_relaxed);
+        }
+    };
+    
+    // Страница попадает на узел потока, который первым в нее пишет. Потоки
+    // очистки закреплены за узлами, кусок c достается узлу c % nodeCount -
+    // таблица чередуется по узлам, а не лежит целиком на узле вызывающего потока.
+    const CpuTopology& topology = cpuTopology();
+    int nodeCount = static_cast<int>(topology.nodes.size());
+    int threadsPerNode = std::max(1, std::min(MAX_CLEAR_THREADS, topology.cpuCount()) / nodeCount);
+    int threads = nodeCount * threadsPerNode;
+    
+    std::stringstream placement;
+    if (chunks < 2 || threads < 2) {
+        for (size_t c = 0; c < chunks; ++c) {
+            clearChunk(c);
+        }
+        placement << "первое касание одним потоком";
+    } else {
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t]() {
+                if (nodeCount > 1) {
+                    pinCurrentThreadToNode(t % nodeCount, t / nodeCount);
+                }
+                for (size_t c = static_cast<size_t>(t); c < chunks; c += static_cast<size_t>(threads)) {
+                    clearChunk(c);
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        placement << "первое касание " << threads << " потоками";
+        if (nodeCount > 1) {
+            placement << ", чередование по " << nodeCount << " NUMA-узлам кусками по "
+                      << CLEAR_CHUNK_BYTES / (1024 * 1024) << " МБ";
+        }
+    }
+    placement_ = placement.str();
+}
+
+bool TranspositionTable::probe(uint64_t key, TTEntry& entry) const {
+    const Slot& slot = slots_[key & mask_];
+    uint64_t data = slot.data.load(std::memory_order_relaxed);
+    uint64_t keyXorData = slot.keyXorData.load(std::memory_order_relaxed);
+    
+    if (data == 0 || (keyXorData ^ data) != key) {
+        return false;
+    }
+    
+    entry = unpack(data);
+    return true;
+}
+
+void TranspositionTable::store(uint64_t key, const Move& move, int score, int depth, Bound bound) {
+    Slot& slot = slots_[key & mask_];
+    uint64_t oldData = slot.data.load(std::memory_order_relaxed);
+    uint64_t oldKey = slot.keyXorData.load(std::memory_order_relaxed) ^ oldData;
+    
+    // Замещение: другая позиция или запись прошлого поиска - всегда;
+    // та же позиция - если новая не намного мельче или оценка точная
+    if (oldData != 0 && oldKey == key && generationOf(oldData) == generation_) {
+        TTEntry old = unpack(oldData);
+        if (bound != Bound::Exact && depth + 2 < old.depth) {
+            return;
+        }
+    }
+    
+    // Без хода сохраняем лучший ход прошлой записи той же позиции
+    Move storedMove = move;
+    if (!storedMove.isValid() && oldData != 0 && oldKey == key) {
+        storedMove = unpack(oldData).move;
+    }
+    
+    uint64_t data = pack(storedMove, score, depth, bound, generation_);
+    slot.keyXorData.store(key ^ data, std::memory_order_relaxed);
+    slot.data.store(data, std::memory_order_relaxed);
+}
+
+int TranspositionTable::hashfull() const {
+    size_t sample = std::min<size_t>(1000, mask_ + 1);
+    int used = 0;
+    for (size_t i = 0; i < sample; ++i) {
+        uint64_t data = slots_[i].data.load(std::memory_order_relaxed);
+        if (data != 0 && generationOf(data) == generation_) {
+            used++;
+        }
+    }
+    return static_cast<int>(used * 1000 / sample);
+}
+
+uint64_t TranspositionTable::pack(const Move& move, int score, int depth, Bound bound,
+                                  uint8_t generation) {
+    uint64_t data = 0;
+    data |= static_cast<uint64_t>(move.from() & 0x3F);
+    data |= static_cast<uint64_t>(move.to() & 0x3F) << 6;
+    data |= static_cast<uint64_t>(static_cast<uint8_t>(move.flag()) & 0x7) << 12;
+    data |= static_cast<uint64_t>(static_cast<uint8_t>(move.promotion()) & 0x7) << 15;
+    data |= static_cast<uint64_t>(static_cast<uint16_t>(static_cast<int16_t>(score))) << SCORE_SHIFT;
+    data |= static_cast<uint64_t>(std::min(std::max(depth, 0), 255)) << DEPTH_SHIFT;
+    data |= static_cast<uint64_t>(static_cast<uint8_t>(bound) & 0x3) << BOUND_SHIFT;
+    data |= static_cast<uint64_t>(generation & GENERATION_MASK) << GENERATION_SHIFT;
+    return data;
+}
+
+TTEntry TranspositionTable::unpack(uint64_t data) {
+    TTEntry entry;
+    entry.move = Move(static_cast<Square>(data & 0x3F),
+                      static_cast<Square>((data >> 6) & 0x3F),
+                      static_cast<MoveFlag>((data >> 12) & 0x7),
+                      static_cast<PieceType>((data >> 15) & 0x7));
+    entry.score = static_cast<int16_t>((data >> SCORE_SHIFT) & 0xFFFF);
+    entry.depth = static_cast<int>((data >> DEPTH_SHIFT) & 0xFF);
+    entry.bound = static_cast<Bound>((data >> BOUND_SHIFT) & 0x3);
+    return entry;
+}
+
+uint8_t TranspositionTable::generationOf(uint64_t data) {
+    return static_cast<uint8_t>((data >> GENERATION_SHIFT) & GENERATION_MASK);
+}
+
+}} // namespace Chess::AI
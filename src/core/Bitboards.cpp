@@ -0,0 +1,99 @@
+#include "core/Bitboards.h"
+
+namespace Chess {
+namespace Bitboards {
+
+namespace {
+
+// Направления лучей: первые четыре идут к старшим клеткам (блокер - младший
+// бит), последние четыре - к младшим (блокер - старший бит)
+enum Direction { North, East, NorthEast, NorthWest, South, West, SouthWest, SouthEast, NUM_DIRECTIONS };
+
+constexpr int DIRECTION_DELTAS[NUM_DIRECTIONS][2] = {
+    {0, 1}, {1, 0}, {1, 1}, {-1, 1}, {0, -1}, {-1, 0}, {-1, -1}, {1, -1}
+};
+
+struct Tables {
+    Bitboard pawn[2][NUM_SQUARES];
+    Bitboard knight[NUM_SQUARES];
+    Bitboard king[NUM_SQUARES];
+    Bitboard rays[NUM_DIRECTIONS][NUM_SQUARES];
+
+    Tables() {
+        const int knightSteps[8][2] = {
+            {-2, -1}, {-2, 1}, {-1, -2}, {-1, 2}, {1, -2}, {1, 2}, {2, -1}, {2, 1}
+        };
+        for (Square sq = 0; sq < NUM_SQUARES; ++sq) {
+            int file = getFile(sq);
+            int rank = getRank(sq);
+            auto target = [&](int df, int dr) -> Bitboard {
+                int f = file + df;
+                int r = rank + dr;
+                return (f >= 0 && f < 8 && r >= 0 && r < 8) ? squareBB(makeSquare(f, r)) : 0;
+            };
+
+            pawn[0][sq] = target(-1, 1) | target(1, 1);
+            pawn[1][sq] = target(-1, -1) | target(1, -1);
+
+            knight[sq] = 0;
+            for (const auto& step : knightSteps) {
+                knight[sq] |= target(step[0], step[1]);
+            }
+
+            king[sq] = 0;
+            for (int df = -1; df <= 1; ++df) {
+                for (int dr = -1; dr <= 1; ++dr) {
+                    if (df != 0 || dr != 0) king[sq] |= target(df, dr);
+                }
+            }
+
+            for (int dir = 0; dir < NUM_DIRECTIONS; ++dir) {
+                rays[dir][sq] = 0;
+                for (int step = 1; step < 8; ++step) {
+                    Bitboard bb = target(DIRECTION_DELTAS[dir][0] * step, DIRECTION_DELTAS[dir][1] * step);
+                    if (!bb) break;
+                    rays[dir][sq] |= bb;
+                }
+            }
+        }
+    }
+};
+
+const Tables TABLES;
+
+// Луч до первого блокера включительно
+inline Bitboard rayAttacks(int dir, Square sq, Bitboard occupied) {
+    Bitboard ray = TABLES.rays[dir][sq];
+    Bitboard blockers = ray & occupied;
+    if (blockers) {
+        Square blocker = dir < South ? lsb(blockers) : msb(blockers);
+        ray ^= TABLES.rays[dir][blocker];
+    }
+    return ray;
+}
+
+} // namespace
+
+Bitboard pawnAttacks(Color color, Square sq) {
+    return TABLES.pawn[static_cast<int>(color)][sq];
+}
+
+Bitboard knightAttacks(Square sq) {
+    return TABLES.knight[sq];
+}
+
+Bitboard kingAttacks(Square sq) {
+    return TABLES.king[sq];
+}
+
+Bitboard bishopAttacks(Square sq, Bitboard occupied) {
+    return rayAttacks(NorthEast, sq, occupied) | rayAttacks(NorthWest, sq, occupied) |
+           rayAttacks(SouthWest, sq, occupied) | rayAttacks(SouthEast, sq, occupied);
+}
+
+Bitboard rookAttacks(Square sq, Bitboard occupied) {
+    return rayAttacks(North, sq, occupied) | rayAttacks(East, sq, occupied) |
+           rayAttacks(South, sq, occupied) | rayAttacks(West, sq, occupied);
+}
+
+}} // namespace Chess::Bitboards
@@ -1,4 +1,6 @@
 #include "core/Board.h"
+#include "core/Bitboards.h"
+#include <algorithm>
 #include <sstream>
 #include <cmath>
 
@@ -6,16 +8,45 @@ namespace Chess {
 
 Board::Board() {
     // Инициализация пустой доски
-    for (auto& sq : squares_) {
-        sq = Piece();
+    clearSquares();
+    hash_ = computeHash();
+}
+
+Board::Board(const Board& other) {
+    copyFrom(other);
+}
+
+Board& Board::operator=(const Board& other) {
+    if (this != &other) {
+        copyFrom(other);
+        if (observer_) {
+            observer_->onReset(*this);
+        }
     }
+    return *this;
+}
+
+void Board::copyFrom(const Board& other) {
+    squares_ = other.squares_;
+    codes_ = other.codes_;
+    position_ = other.position_;
+    hash_ = other.hash_;
+    pawnKey_ = other.pawnKey_;
+    materialKey_ = other.materialKey_;
+    phase_ = other.phase_;
+    std::copy(&other.pieces_[0][0], &other.pieces_[0][0] + 2 * 7, &pieces_[0][0]);
+    occupied_[0] = other.occupied_[0];
+    occupied_[1] = other.occupied_[1];
+    history_ = other.history_;
 }
 
 void Board::setupInitialPosition() {
+    // Наблюдатель получит одно onReset вместо изменений по клеткам
+    BoardObserver* observer = observer_;
+    observer_ = nullptr;
+    
     // Очистка доски
-    for (auto& sq : squares_) {
-        sq = Piece();
-    }
+    clearSquares();
     
     // Белые фигуры
     setPiece(makeSquare(0, 0), Piece(PieceType::Rook, Color::White));
@@ -49,16 +80,19 @@ void Board::setupInitialPosition() {
     
     // Установка начальной позиции
     position_ = Position();
+    hash_ = computeHash();
+    observer_ = observer;
+    if (observer_) {
+        observer_->onReset(*this);
+    }
 }
 
 Square Board::findKing(Color color) const {
-    for (Square sq = 0; sq < NUM_SQUARES; ++sq) {
-        const Piece& piece = pieceAt(sq);
-        if (piece.type() == PieceType::King && piece.color() == color) {
-            return sq;
-        }
+    Bitboard king = pieces(color, PieceType::King);
+    if (!king) {
+        return 255; // Не найден (не должно случиться в нормальной игре)
     }
-    return 255; // Не найден (не должно случиться в нормальной игре)
+    return Bitboards::lsb(king);
 }
 
 bool Board::isSquareAttacked(Square sq, Color byColor) const {
@@ -172,7 +206,14 @@ void Board::makeMove(const Move& move) {
     UndoInfo undo;
     undo.capturedPiece = pieceAt(move.to());
     undo.state = position_.getState();
+    undo.hash = hash_;
     history_.push_back(undo);
+    if (observer_) {
+        observer_->onMakeMove();
+    }
+    
+    // Фигуры обновляют хеш в setPiece, состояние позиции - целиком
+    hash_ ^= positionStateKey();
     
     Piece movingPiece = pieceAt(move.from());
     
@@ -251,6 +292,8 @@ void Board::makeMove(const Move& move) {
         position_.fullmoveNumber()++;
     }
     position_.setSideToMove(nextSide);
+    
+    hash_ ^= positionStateKey();
 }
 
 void Board::unmakeMove(const Move& move) {
@@ -262,6 +305,10 @@ void Board::unmakeMove(const Move& move) {
     // Восстановить состояние позиции
     position_.setState(undo.state);
     
+    // Наблюдатель не видит восстановления фигур - он вернет свое сохраненное состояние
+    BoardObserver* observer = observer_;
+    observer_ = nullptr;
+    
     // Вернуть фигуру назад
     Piece movingPiece = pieceAt(move.to());
     setPiece(move.from(), movingPiece);
@@ -298,6 +345,84 @@ void Board::unmakeMove(const Move& move) {
         setPiece(captureSq, Piece(PieceType::Pawn, opponentColor));
         removePiece(move.to());
     }
+    
+    hash_ = undo.hash;
+    observer_ = observer;
+    if (observer_) {
+        observer_->onUnmakeMove();
+    }
+}
+
+void Board::makeNullMove() {
+    UndoInfo undo;
+    undo.capturedPiece = Piece();
+    undo.state = position_.getState();
+    undo.hash = hash_;
+    history_.push_back(undo);
+    if (observer_) {
+        observer_->onMakeMove();
+    }
+    
+    hash_ ^= positionStateKey();
+    position_.setEnPassantSquare(255);
+    position_.halfmoveClock()++;
+    position_.setSideToMove(oppositeColor(position_.sideToMove()));
+    hash_ ^= positionStateKey();
+}
+
+void Board::unmakeNullMove() {
+    if (history_.empty()) return;
+    
+    UndoInfo undo = history_.back();
+    history_.pop_back();
+    
+    position_.setState(undo.state);
+    hash_ = undo.hash;
+    if (observer_) {
+        observer_->onUnmakeMove();
+    }
+}
+
+bool Board::hasNonPawnMaterial(Color color) const {
+    return (pieces(color, PieceType::Knight) | pieces(color, PieceType::Bishop) |
+            pieces(color, PieceType::Rook) | pieces(color, PieceType::Queen)) != 0;
+}
+
+void Board::clearSquares() {
+    for (auto& sq : squares_) {
+        sq = Piece();
+    }
+    codes_.fill(0);
+    pawnKey_ = 0;
+    materialKey_ = 0;
+    phase_ = 0;
+    for (auto& byColor : pieces_) {
+        for (auto& bb : byColor) bb = 0;
+    }
+    occupied_[0] = occupied_[1] = 0;
+}
+
+uint64_t Board::computeHash() const {
+    uint64_t hash = positionStateKey();
+    for (Square sq = 0; sq < NUM_SQUARES; ++sq) {
+        hash ^= Zobrist::piece(squares_[sq], sq);
+    }
+    return hash;
+}
+
+uint64_t Board::positionStateKey() const {
+    uint64_t key = 0;
+    if (position_.sideToMove() == Color::Black) {
+        key ^= Zobrist::sideToMove();
+    }
+    if (position_.canCastleKingside(Color::White)) key ^= Zobrist::castling(0);
+    if (position_.canCastleQueenside(Color::White)) key ^= Zobrist::castling(1);
+    if (position_.canCastleKingside(Color::Black)) key ^= Zobrist::castling(2);
+    if (position_.canCastleQueenside(Color::Black)) key ^= Zobrist::castling(3);
+    if (position_.enPassantSquare() != 255) {
+        key ^= Zobrist::enPassantFile(getFile(position_.enPassantSquare()));
+    }
+    return key;
 }
 
 std::string Board::toString() const {
@@ -324,6 +449,17 @@ bool Board::isStalemate(Color color) const {
     return false;
 }
 
+int Board::repetitionCount() const {
+    int count = 0;
+    int limit = std::min(static_cast<int>(history_.size()), position_.halfmoveClock());
+    for (int i = 1; i <= limit; ++i) {
+        if (history_[history_.size() - i].hash == hash_) {
+            count++;
+        }
+    }
+    return count;
+}
+
 bool Board::isDraw() const {
     // Проверка на ничью по правилу 50 ходов
     if (position_.halfmoveClock() >= 100) {
@@ -337,10 +473,12 @@ bool Board::isDraw() const {
 }
 
 void Board::setFromFEN(const std::string& fen) {
+    // Наблюдатель получит одно onReset вместо изменений по клеткам
+    BoardObserver* observer = observer_;
+    observer_ = nullptr;
+    
     // Очистка доски
-    for (auto& sq : squares_) {
-        sq = Piece();
-    }
+    clearSquares();
     
     std::istringstream ss(fen);
     std::string boardPart;
@@ -377,6 +515,64 @@ void Board::setFromFEN(const std::string& fen) {
     
     // Парсинг остальной части FEN
     position_.setFromFEN(fen);
+    hash_ = computeHash();
+    observer_ = observer;
+    if (observer_) {
+        observer_->onReset(*this);
+    }
+}
+
+PackedPosition Board::pack() const {
+    PackedPosition packed = {};
+    packed.occupied = occupied();
+    Bitboard bits = packed.occupied;
+    for (int index = 0; bits && index < 32; ++index) {
+        Square sq = Bitboards::popLsb(bits);
+        packed.pieces[index / 2] |= static_cast<uint8_t>(codes_[sq] << ((index % 2) * 4));
+    }
+    packed.sideToMove = static_cast<uint8_t>(position_.sideToMove());
+    packed.castling = static_cast<uint8_t>((position_.canCastleKingside(Color::White) ? 1 : 0) |
+                                           (position_.canCastleQueenside(Color::White) ? 2 : 0) |
+                                           (position_.canCastleKingside(Color::Black) ? 4 : 0) |
+                                           (position_.canCastleQueenside(Color::Black) ? 8 : 0));
+    packed.enPassant = position_.enPassantSquare();
+    packed.halfmoveClock = static_cast<uint8_t>(std::min(position_.halfmoveClock(), 255));
+    packed.fullmoveNumber = static_cast<uint16_t>(std::min(position_.fullmoveNumber(), 65535));
+    return packed;
+}
+
+void Board::setFromPacked(const PackedPosition& packed) {
+    BoardObserver* observer = observer_;
+    observer_ = nullptr;
+    
+    clearSquares();
+    history_.clear();
+    
+    // Больше 32 фигур запись не вмещает; неверные коды пропускаются
+    Bitboard bits = packed.occupied;
+    for (int index = 0; bits && index < 32; ++index) {
+        Square sq = Bitboards::popLsb(bits);
+        int code = (packed.pieces[index / 2] >> ((index % 2) * 4)) & 0xF;
+        if ((code & 7) == 0 || (code & 7) > static_cast<int>(PieceType::King)) continue;
+        setPiece(sq, Piece(static_cast<PieceType>(code & 7), static_cast<Color>(code >> 3)));
+    }
+    
+    PositionState state;
+    state.sideToMove = static_cast<Color>(packed.sideToMove & 1);
+    state.enPassantSquare = packed.enPassant;
+    state.whiteCanCastleKingside = (packed.castling & 1) != 0;
+    state.whiteCanCastleQueenside = (packed.castling & 2) != 0;
+    state.blackCanCastleKingside = (packed.castling & 4) != 0;
+    state.blackCanCastleQueenside = (packed.castling & 8) != 0;
+    state.halfmoveClock = packed.halfmoveClock;
+    state.fullmoveNumber = packed.fullmoveNumber;
+    position_.setState(state);
+    
+    hash_ = computeHash();
+    observer_ = observer;
+    if (observer_) {
+        observer_->onReset(*this);
+    }
 }
 
 std::string Board::toFEN() const {
@@ -33,6 +33,7 @@ void Position::setCastlingRights(Color c, bool kingside, bool queenside) {
 
 PositionState Position::getState() const {
     return PositionState{
+        sideToMove_,
         enPassantSquare_,
         whiteCanCastleKingside_,
         whiteCanCastleQueenside_,
@@ -44,6 +45,7 @@ PositionState Position::getState() const {
 }
 
 void Position::setState(const PositionState& state) {
+    sideToMove_ = state.sideToMove;
     enPassantSquare_ = state.enPassantSquare;
     whiteCanCastleKingside_ = state.whiteCanCastleKingside;
     whiteCanCastleQueenside_ = state.whiteCanCastleQueenside;
@@ -0,0 +1,59 @@
+#include "core/Zobrist.h"
+
+namespace Chess {
+namespace Zobrist {
+
+namespace {
+
+struct Keys {
+    // [цвет][тип фигуры][клетка], тип None не используется
+    uint64_t pieces[2][7][NUM_SQUARES];
+    uint64_t side;
+    uint64_t castling[4];
+    uint64_t enPassant[BOARD_SIZE];
+
+    Keys() {
+        // SplitMix64 с фиксированным зерном - ключи одинаковы в каждом запуске
+        uint64_t state = 0x9E3779B97F4A7C15ULL;
+        auto next = [&state]() {
+            uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return z ^ (z >> 31);
+        };
+        
+        for (auto& byColor : pieces) {
+            for (auto& byType : byColor) {
+                for (auto& key : byType) {
+                    key = next();
+                }
+            }
+        }
+        side = next();
+        for (auto& key : castling) key = next();
+        for (auto& key : enPassant) key = next();
+    }
+};
+
+const Keys KEYS;
+
+} // namespace
+
+uint64_t piece(const Piece& piece, Square sq) {
+    if (piece.isNone()) return 0;
+    return KEYS.pieces[static_cast<int>(piece.color())][static_cast<int>(piece.type())][sq];
+}
+
+uint64_t sideToMove() {
+    return KEYS.side;
+}
+
+uint64_t castling(int index) {
+    return KEYS.castling[index];
+}
+
+uint64_t enPassantFile(int file) {
+    return KEYS.enPassant[file];
+}
+
+}} // namespace Chess::Zobrist
@@ -0,0 +1,123 @@
+#include "ai/BatchEvaluator.h"
+#include "ai/Nnue.h"
+#include "core/Board.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using namespace Chess;
+using namespace Chess::AI;
+
+namespace {
+
+void printUsage() {
+    std::cout <<
+        "chess-label - массовая оценка позиций для разметки датасетов\n"
+        "\n"
+        "  chess-label pack ВХОД ВЫХОД     EPD/FEN (позиция в строке) -> записи PackedPosition\n"
+        "  chess-label eval ВХОД ВЫХОД     записи PackedPosition -> int16 оценки за сторону на ходу\n"
+        "  --qsearch                оценка quiescence-поиском (по умолчанию - статическая)\n"
+        "  --threads N              потоков (по умолчанию - число CPU)\n"
+        "  --nnue ФАЙЛ              нейросетевая оценка вместо классической\n";
+}
+
+// Позиция - первые четыре поля строки; счетчики ходов берутся, если есть
+std::string fenOf(const std::string& line) {
+    std::istringstream ss(line);
+    std::string field, fen;
+    for (int i = 0; i < 6 && ss >> field; ++i) {
+        bool counter = std::all_of(field.begin(), field.end(), [](unsigned char c) { return std::isdigit(c); });
+        if (i >= 4 && !counter) break;
+        fen += (i ? " " : "") + field;
+    }
+    return fen;
+}
+
+int pack(const std::string& inputPath, const std::string& outputPath) {
+    std::ifstream input(inputPath);
+    std::ofstream output(outputPath, std::ios::binary);
+    if (!input.is_open() || !output.is_open()) {
+        std::cerr << "не удалось открыть " << (input.is_open() ? outputPath : inputPath) << std::endl;
+        return 1;
+    }
+    Board board;
+    std::string line;
+    size_t count = 0;
+    while (std::getline(input, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        board.setFromFEN(fenOf(line));
+        PackedPosition packed = board.pack();
+        output.write(reinterpret_cast<const char*>(&packed), sizeof(packed));
+        count++;
+    }
+    std::cout << "Записано позиций: " << count << std::endl;
+    return output ? 0 : 1;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 4) {
+        printUsage();
+        return 1;
+    }
+    std::string command = argv[1];
+    std::string inputPath = argv[2];
+    std::string outputPath = argv[3];
+
+    if (command == "pack") {
+        return pack(inputPath, outputPath);
+    }
+    if (command != "eval") {
+        printUsage();
+        return 1;
+    }
+
+    BatchOptions options;
+    options.threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    try {
+        for (int i = 4; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--qsearch") {
+                options.mode = BatchMode::Quiescence;
+            } else if (arg == "--threads" && i + 1 < argc) {
+                options.threads = std::max(1, std::stoi(argv[++i]));
+            } else if (arg == "--nnue" && i + 1 < argc) {
+                auto network = std::make_shared<Nnue::Network>();
+                std::string error;
+                if (!network->load(argv[++i], error)) {
+                    std::cerr << error << std::endl;
+                    return 1;
+                }
+                options.network = network;
+            } else {
+                std::cerr << "Неизвестный или неполный аргумент: " << arg << std::endl;
+                printUsage();
+                return 1;
+            }
+        }
+    } catch (const std::exception&) {
+        std::cerr << "Неверное число в аргументах" << std::endl;
+        return 1;
+    }
+
+    BatchEvaluator evaluator(options);
+    std::string error;
+    size_t count = 0;
+    auto start = std::chrono::steady_clock::now();
+    if (!evaluator.evaluateFile(inputPath, outputPath, count, error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Оценено позиций: " << count << " за " << elapsed << " с ("
+              << static_cast<uint64_t>(elapsed > 0 ? count / elapsed : 0) << " поз/с, потоков "
+              << options.threads << ")" << std::endl;
+    return 0;
+}
@@ -1,7 +1,60 @@
 #include <QApplication>
 #include "ui/MainWindow.h"
+#include "ai/Bench.h"
+#include "ai/Nnue.h"
+#include "ai/ThreadPlacement.h"
+#include <cstdlib>
+#include <iostream>
+#include <string>
 
 int main(int argc, char* argv[]) {
+    // chess-ai --bench [глубина] [none|compact|scatter]: бенчмарк без GUI.
+    // Без политики - детерминированный, с политикой - многопоточный, для
+    // сравнения скорости при разном закреплении потоков.
+    if (argc >= 2 && std::string(argv[1]) == "--bench") {
+        int depth = (argc >= 3) ? std::atoi(argv[2]) : 5;
+        bool deterministic = true;
+        if (argc >= 4) {
+            std::string policy = argv[3];
+            deterministic = false;
+            if (policy == "compact") {
+                Chess::AI::setAffinityPolicy(Chess::AI::AffinityPolicy::Compact);
+            } else if (policy == "scatter") {
+                Chess::AI::setAffinityPolicy(Chess::AI::AffinityPolicy::Scatter);
+            }
+        }
+        Chess::AI::runBench(depth, &std::cout, deterministic);
+        return 0;
+    }
+    
+    // chess-ai --eval-bench [глубина]: ядра материала и PSQT классической
+    // оценки - совпадение с эталоном и скорость
+    if (argc >= 2 && std::string(argv[1]) == "--eval-bench") {
+        int depth = (argc >= 3) ? std::atoi(argv[2]) : 5;
+        Chess::AI::EvalBenchResult result = Chess::AI::runEvalBench(depth, &std::cout);
+        return result.kernelsExact ? 0 : 1;
+    }
+    
+    // chess-ai --nnue-bench <файл сети|random> [глубина]: точность и скорость
+    // нейросетевой оценки против классической
+    if (argc >= 3 && std::string(argv[1]) == "--nnue-bench") {
+        std::string path = argv[2];
+        int depth = (argc >= 4) ? std::atoi(argv[3]) : 5;
+        std::shared_ptr<Chess::AI::Nnue::Network> network;
+        if (path == "random") {
+            network = Chess::AI::Nnue::Network::makeRandom(1);
+        } else {
+            network = std::make_shared<Chess::AI::Nnue::Network>();
+            std::string error;
+            if (!network->load(path, error)) {
+                std::cerr << error << std::endl;
+                return 1;
+            }
+        }
+        Chess::AI::runNnueBench(network, depth, &std::cout);
+        return 0;
+    }
+    
     QApplication app(argc, argv);
     
     // Установка настроек приложения
@@ -0,0 +1,77 @@
+#include "match/EnginePlugin.h"
+#include "match/Player.h"
+#include <cstring>
+#include <sstream>
+
+using Chess::Board;
+using Chess::Move;
+using Chess::Match::Player;
+
+// Плагин - тонкая обертка над Player этой сборки. Исключения через границу
+// C-интерфейса не выпускаем.
+
+void* chess_plugin_create(const char* options) {
+    try {
+        Chess::Match::PlayerConfig config;
+        std::string error;
+        if (!Chess::Match::parsePlayerConfig(options ? options : "", config, error)) {
+            return nullptr;
+        }
+        config.pluginPath.clear();  // Внутри плагина - всегда собственный движок
+        return Chess::Match::createPlayer(config, error).release();
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void chess_plugin_destroy(void* player) {
+    delete static_cast<Player*>(player);
+}
+
+void chess_plugin_new_game(void* player) {
+    try {
+        static_cast<Player*>(player)->newGame();
+    } catch (...) {
+    }
+}
+
+int chess_plugin_think(void* player, const char* fen, const char* moves,
+                       int depth, unsigned long long nodes, int moveTimeMs,
+                       char* moveOut, int moveOutSize, int* scoreOut) {
+    try {
+        Board board;
+        board.setFromFEN(fen);
+        std::vector<Move> history;
+        std::stringstream ss(moves ? moves : "");
+        std::string token;
+        while (ss >> token) {
+            Move move = Chess::Match::parseUciMove(board, token);
+            if (!move.isValid()) {
+                return 1;
+            }
+            board.makeMove(move);
+            history.push_back(move);
+        }
+
+        Chess::Match::SearchLimits limits;
+        limits.depth = depth;
+        limits.nodes = nodes;
+        limits.moveTimeMs = moveTimeMs;
+        Chess::Match::PlayerMove result = static_cast<Player*>(player)->think(board, fen, history, limits);
+        if (!result.move.isValid()) {
+            return 1;
+        }
+
+        std::string text = Chess::Match::moveToUci(result.move);
+        if (static_cast<int>(text.size()) >= moveOutSize) {
+            return 1;
+        }
+        std::memcpy(moveOut, text.c_str(), text.size() + 1);
+        if (scoreOut) {
+            *scoreOut = result.score;
+        }
+        return 0;
+    } catch (...) {
+        return 1;
+    }
+}
@@ -0,0 +1,296 @@
+#include "match/MatchRunner.h"
+#include "core/MoveGenerator.h"
+#include <algorithm>
+#include <chrono>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+namespace Chess {
+namespace Match {
+
+namespace {
+
+// Доля оставшегося времени на ход при игре на часах
+constexpr int MOVES_TO_GO = 30;
+constexpr int CLOCK_SAFETY_MS = 20;
+
+// Голые короли или король с одной легкой фигурой против короля
+bool insufficientMaterial(const Board& board) {
+    int minors = 0;
+    for (Square sq = 0; sq < NUM_SQUARES; ++sq) {
+        const Piece& piece = board.pieceAt(sq);
+        if (piece.isNone() || piece.type() == PieceType::King) continue;
+        if (piece.type() == PieceType::Knight || piece.type() == PieceType::Bishop) {
+            minors++;
+        } else {
+            return false;
+        }
+    }
+    return minors <= 1;
+}
+
+const char* outcomeText(GameOutcome outcome) {
+    switch (outcome) {
+        case GameOutcome::WhiteWins: return "1-0";
+        case GameOutcome::BlackWins: return "0-1";
+        default: return "1/2-1/2";
+    }
+}
+
+GameOutcome winnerOutcome(Color winner) {
+    return winner == Color::White ? GameOutcome::WhiteWins : GameOutcome::BlackWins;
+}
+
+} // namespace
+
+MatchRunner::MatchRunner(PlayerConfig first, PlayerConfig second, MatchOptions options)
+    : first_(std::move(first)), second_(std::move(second)), options_(std::move(options)) {
+    if (options_.openings.empty()) {
+        options_.openings = defaultOpenings();
+    }
+    options_.concurrency = std::max(1, options_.concurrency);
+}
+
+std::vector<std::string> MatchRunner::defaultOpenings() {
+    return {
+        "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq - 0 1",
+        "rnbqkbnr/pppppppp/8/8/3P4/8/PPP1PPPP/RNBQKBNR b KQkq - 0 1",
+        "rnbqkbnr/pppppppp/8/8/2P5/8/PP1PPPPP/RNBQKBNR b KQkq - 0 1",
+        "rnbqkbnr/pppppppp/8/8/8/5N2/PPPPPPPP/RNBQKB1R b KQkq - 1 1",
+        "rnbqkbnr/pp1ppppp/8/2p5/4P3/8/PPPP1PPP/RNBQKBNR w KQkq - 0 2",
+        "rnbqkbnr/pppp1ppp/8/4p3/4P3/8/PPPP1PPP/RNBQKBNR w KQkq - 0 2",
+        "rnbqkbnr/pppp1ppp/4p3/8/4P3/8/PPPP1PPP/RNBQKBNR w KQkq - 0 2",
+        "rnbqkbnr/pp1ppppp/2p5/8/4P3/8/PPPP1PPP/RNBQKBNR w KQkq - 0 2",
+        "rnbqkbnr/ppp1pppp/8/3p4/3P4/8/PPP1PPPP/RNBQKBNR w KQkq - 0 2",
+        "rnbqkb1r/pppppppp/5n2/8/3P4/8/PPP1PPPP/RNBQKBNR w KQkq - 1 2",
+        "r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3",
+        "rnbqkb1r/pppp1ppp/4pn2/8/2PP4/8/PP2PPPP/RNBQKBNR w KQkq - 0 3",
+    };
+}
+
+bool MatchRunner::loadOpenings(const std::string& path, std::vector<std::string>& openings,
+                               std::string& error) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        error = "не удалось открыть файл дебютов " + path;
+        return false;
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::stringstream ss(line);
+        std::string fields[6];
+        int count = 0;
+        while (count < 6 && ss >> fields[count]) {
+            count++;
+        }
+        if (count < 4) continue;
+        // EPD: после четырех полей идут операции, а не счетчики ходов
+        bool fullFen = count == 6 && std::isdigit(static_cast<unsigned char>(fields[4][0])) &&
+                       std::isdigit(static_cast<unsigned char>(fields[5][0]));
+        std::string fen = fields[0] + " " + fields[1] + " " + fields[2] + " " + fields[3];
+        fen += fullFen ? " " + fields[4] + " " + fields[5] : " 0 1";
+        openings.push_back(fen);
+    }
+    if (openings.empty()) {
+        error = "в файле " + path + " нет позиций";
+        return false;
+    }
+    return true;
+}
+
+bool MatchRunner::run(std::ostream& out, MatchScore& score, std::string& error) {
+    // Движки создаются заранее: ошибку (например, плагин) видно до начала матча
+    struct Pair {
+        std::unique_ptr<Player> first;
+        std::unique_ptr<Player> second;
+    };
+    std::vector<Pair> pairs(options_.concurrency);
+    for (Pair& pair : pairs) {
+        pair.first = createPlayer(first_, error);
+        if (!pair.first) return false;
+        pair.second = createPlayer(second_, error);
+        if (!pair.second) return false;
+    }
+
+    std::unique_ptr<Sprt> sprt;
+    if (options_.sprtEnabled) {
+        sprt = std::make_unique<Sprt>(options_.elo0, options_.elo1, options_.alpha, options_.beta);
+    }
+
+    out << "Матч: " << first_.name << " против " << second_.name
+        << ", партий до " << options_.maxGames
+        << ", одновременно " << options_.concurrency
+        << ", дебютов " << options_.openings.size() << std::endl;
+
+    score = MatchScore();
+    nextGame_ = 0;
+    finished_ = false;
+
+    auto worker = [&](Pair& pair) {
+        while (!finished_) {
+            int game = nextGame_++;
+            if (game >= options_.maxGames) break;
+
+            // Каждый дебют - дважды, первый движок по очереди белыми и черными
+            const std::string& fen = options_.openings[(game / 2) % options_.openings.size()];
+            bool firstIsWhite = (game % 2 == 0);
+            Player& white = firstIsWhite ? *pair.first : *pair.second;
+            Player& black = firstIsWhite ? *pair.second : *pair.first;
+            white.newGame();
+            black.newGame();
+
+            GameRecord record = playGame(white, black, fen);
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (record.outcome == GameOutcome::Draw) {
+                score.draws++;
+            } else if ((record.outcome == GameOutcome::WhiteWins) == firstIsWhite) {
+                score.wins++;
+            } else {
+                score.losses++;
+            }
+
+            out << "Партия " << game + 1 << " (" << (firstIsWhite ? first_.name : second_.name)
+                << " белыми): " << outcomeText(record.outcome) << " " << record.reason
+                << ", " << record.plies << " полуходов" << std::endl;
+            if (score.games() % options_.reportEvery == 0) {
+                out << formatProgress(score, sprt.get()) << std::endl;
+            }
+            if (sprt && sprt->decide(score) != Sprt::Decision::Continue) {
+                finished_ = true;
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < pairs.size(); ++i) {
+        threads.emplace_back(worker, std::ref(pairs[i]));
+    }
+    worker(pairs[0]);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    out << "Итог: " << formatProgress(score, sprt.get()) << std::endl;
+    if (sprt) {
+        switch (sprt->decide(score)) {
+            case Sprt::Decision::AcceptH1:
+                out << "SPRT: H1 принята - " << first_.name << " сильнее" << std::endl;
+                break;
+            case Sprt::Decision::AcceptH0:
+                out << "SPRT: H0 принята - улучшение не подтверждено" << std::endl;
+                break;
+            default:
+                out << "SPRT: решение не принято" << std::endl;
+                break;
+        }
+    }
+    return true;
+}
+
+GameRecord MatchRunner::playGame(Player& white, Player& black, const std::string& fen) {
+    Board board;
+    board.setFromFEN(fen);
+    std::vector<Move> moves;
+    GameRecord record;
+
+    int clock[2] = {options_.baseTimeMs, options_.baseTimeMs};
+    bool useClock = options_.baseTimeMs > 0;
+    Color adjudicatedWinner = Color::None;
+    int winStreak = 0;
+    int drawStreak = 0;
+
+    for (record.plies = 0; record.plies < options_.maxPlies; ++record.plies) {
+        Color side = board.position().sideToMove();
+        MoveGenerator generator(board);
+        std::vector<Move> legalMoves = generator.generateLegalMoves(side);
+
+        if (legalMoves.empty()) {
+            if (board.isCheck(side)) {
+                record.outcome = winnerOutcome(oppositeColor(side));
+                record.reason = "мат";
+            } else {
+                record.outcome = GameOutcome::Draw;
+                record.reason = "пат";
+            }
+            return record;
+        }
+        if (board.isDraw()) {
+            record.reason = "правило 50 ходов";
+            return record;
+        }
+        if (board.repetitionCount() >= 2) {
+            record.reason = "троекратное повторение";
+            return record;
+        }
+        if (insufficientMaterial(board)) {
+            record.reason = "недостаточно материала";
+            return record;
+        }
+
+        SearchLimits limits = options_.limits;
+        int sideIndex = static_cast<int>(side);
+        if (useClock) {
+            int budget = clock[sideIndex] / MOVES_TO_GO + options_.incrementMs * 3 / 4;
+            budget = std::min(budget, clock[sideIndex] - CLOCK_SAFETY_MS);
+            limits.moveTimeMs = std::max(1, limits.moveTimeMs > 0 ? std::min(limits.moveTimeMs, budget) : budget);
+        }
+
+        Player& player = (side == Color::White) ? white : black;
+        auto start = std::chrono::steady_clock::now();
+        PlayerMove answer = player.think(board, fen, moves, limits);
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+
+        if (useClock) {
+            clock[sideIndex] -= static_cast<int>(elapsed);
+            if (clock[sideIndex] < 0) {
+                record.outcome = winnerOutcome(oppositeColor(side));
+                record.reason = "просрочка времени";
+                return record;
+            }
+            clock[sideIndex] += options_.incrementMs;
+        }
+
+        if (std::find(legalMoves.begin(), legalMoves.end(), answer.move) == legalMoves.end()) {
+            record.outcome = winnerOutcome(oppositeColor(side));
+            record.reason = "нелегальный ход";
+            return record;
+        }
+
+        // Адъюдикация по оценкам обоих движков
+        Color leader = Color::None;
+        if (answer.score >= options_.resignScore) {
+            leader = side;
+        } else if (answer.score <= -options_.resignScore) {
+            leader = oppositeColor(side);
+        }
+        winStreak = (leader != Color::None && leader == adjudicatedWinner) ? winStreak + 1 : 1;
+        adjudicatedWinner = leader;
+        if (leader != Color::None && winStreak >= 2 * options_.resignMoves) {
+            record.outcome = winnerOutcome(leader);
+            record.reason = "адъюдикация: решающий перевес";
+            return record;
+        }
+
+        bool drawish = board.position().fullmoveNumber() >= options_.drawMoveNumber &&
+                       std::abs(answer.score) <= options_.drawScore;
+        drawStreak = drawish ? drawStreak + 1 : 0;
+        if (drawStreak >= 2 * options_.drawMoves) {
+            record.reason = "адъюдикация: ничейная позиция";
+            return record;
+        }
+
+        board.makeMove(answer.move);
+        moves.push_back(answer.move);
+    }
+
+    record.reason = "предел длины партии";
+    return record;
+}
+
+}} // namespace Chess::Match
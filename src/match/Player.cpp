@@ -0,0 +1,320 @@
+#include "match/Player.h"
+#include "match/EnginePlugin.h"
+#include "ai/MctsEngine.h"
+#include "ai/Nnue.h"
+#include "core/MoveGenerator.h"
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <sstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <dlfcn.h>
+#define CHESS_MATCH_HAVE_DLOPEN 1
+#endif
+
+namespace Chess {
+namespace Match {
+
+namespace {
+
+constexpr int DEFAULT_DEPTH = 5;        // Если не задано ни одного лимита
+constexpr int UNLIMITED_DEPTH = 60;     // Лимит по узлам или времени - глубина не ограничивает
+constexpr int MCTS_SIMULATIONS_PER_DEPTH = 1000;
+
+int searchDepth(const PlayerConfig& config, const SearchLimits& limits) {
+    int depth = config.depth;
+    if (limits.depth > 0) {
+        depth = (depth > 0) ? std::min(depth, limits.depth) : limits.depth;
+    }
+    if (depth > 0) {
+        return depth;
+    }
+    return (limits.nodes > 0 || limits.moveTimeMs > 0) ? UNLIMITED_DEPTH : DEFAULT_DEPTH;
+}
+
+// Сеть загружается один раз на файл и общая для всех движков матча
+std::shared_ptr<const AI::Nnue::Network> loadNetwork(const std::string& path, std::string& error) {
+    static std::mutex mutex;
+    static std::map<std::string, std::shared_ptr<const AI::Nnue::Network>> loaded;
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = loaded.find(path);
+    if (it != loaded.end()) {
+        return it->second;
+    }
+    auto network = std::make_shared<AI::Nnue::Network>();
+    if (!network->load(path, error)) {
+        return nullptr;
+    }
+    loaded[path] = network;
+    return network;
+}
+
+// Alpha-beta движок этой сборки
+class EnginePlayer : public Player {
+public:
+    EnginePlayer(const PlayerConfig& config, std::shared_ptr<const AI::Nnue::Network> network)
+        : config_(config), engine_(board_) {
+        engine_.setLogFile("");
+        engine_.setParallelRoot(false);  // Параллельны партии, а не поиск внутри
+        engine_.setSearchParams(config.params);
+        engine_.setHashSize(config.hashMb);
+        engine_.setNnue(std::move(network));
+    }
+
+    void newGame() override {
+        engine_.clearHash();
+    }
+
+    PlayerMove think(const Board& board, const std::string&, const std::vector<Move>&,
+                     const SearchLimits& limits) override {
+        board_ = board;
+        Color side = board_.position().sideToMove();
+        int depth = searchDepth(config_, limits);
+        engine_.setDifficulty(depth);
+
+        AI::SearchResult result;
+        if (limits.nodes > 0) {
+            result = engine_.findBestMoveWithNodeLimit(side, limits.nodes);
+        } else if (limits.moveTimeMs > 0) {
+            result = engine_.findBestMoveWithTimeLimit(side, limits.moveTimeMs);
+        } else {
+            result = engine_.findBestMove(side, depth);
+        }
+        return PlayerMove{result.bestMove, result.score};
+    }
+
+private:
+    PlayerConfig config_;
+    Board board_;
+    AI::Engine engine_;
+};
+
+// MCTS движок этой сборки. Лимит глубины переводится в число симуляций.
+class MctsPlayer : public Player {
+public:
+    explicit MctsPlayer(const PlayerConfig& config) : config_(config), engine_(board_) {
+        AI::MctsParams params;
+        params.threads = config.threads;
+        params.poolSizeMb = config.hashMb;
+        engine_.setParams(params);
+    }
+
+    void newGame() override {
+        engine_.clearTree();
+    }
+
+    PlayerMove think(const Board& board, const std::string&, const std::vector<Move>&,
+                     const SearchLimits& limits) override {
+        board_ = board;
+        Color side = board_.position().sideToMove();
+
+        AI::SearchResult result;
+        if (limits.nodes > 0) {
+            result = engine_.findBestMove(side, static_cast<int>(limits.nodes));
+        } else if (limits.moveTimeMs > 0) {
+            result = engine_.findBestMoveWithTimeLimit(side, limits.moveTimeMs);
+        } else {
+            result = engine_.findBestMove(side, searchDepth(config_, limits) * MCTS_SIMULATIONS_PER_DEPTH);
+        }
+        return PlayerMove{result.bestMove, result.score};
+    }
+
+private:
+    PlayerConfig config_;
+    Board board_;
+    AI::MctsEngine engine_;
+};
+
+#ifdef CHESS_MATCH_HAVE_DLOPEN
+// Движок другой сборки через C-интерфейс плагина
+class PluginPlayer : public Player {
+public:
+    ~PluginPlayer() override {
+        if (player_) {
+            destroy_(player_);
+        }
+        if (library_) {
+            dlclose(library_);
+        }
+    }
+
+    bool load(const PlayerConfig& config, std::string& error) {
+        // RTLD_LOCAL: символы двух плагинов не смешиваются
+        library_ = dlopen(config.pluginPath.c_str(), RTLD_NOW | RTLD_LOCAL);
+        if (!library_) {
+            error = "не удалось загрузить плагин " + config.pluginPath + ": " + dlerror();
+            return false;
+        }
+        auto create = reinterpret_cast<ChessPluginCreateFn>(dlsym(library_, "chess_plugin_create"));
+        destroy_ = reinterpret_cast<ChessPluginDestroyFn>(dlsym(library_, "chess_plugin_destroy"));
+        newGame_ = reinterpret_cast<ChessPluginNewGameFn>(dlsym(library_, "chess_plugin_new_game"));
+        think_ = reinterpret_cast<ChessPluginThinkFn>(dlsym(library_, "chess_plugin_think"));
+        if (!create || !destroy_ || !newGame_ || !think_) {
+            error = "в плагине " + config.pluginPath + " нет функций chess_plugin_*";
+            return false;
+        }
+        player_ = create(config.options.c_str());
+        if (!player_) {
+            error = "плагин " + config.pluginPath + " не принял настройки: " + config.options;
+            return false;
+        }
+        return true;
+    }
+
+    void newGame() override {
+        newGame_(player_);
+    }
+
+    PlayerMove think(const Board& board, const std::string& startFen, const std::vector<Move>& moves,
+                     const SearchLimits& limits) override {
+        std::string history;
+        for (const Move& move : moves) {
+            if (!history.empty()) history += ' ';
+            history += moveToUci(move);
+        }
+
+        char moveText[16] = {0};
+        int score = 0;
+        PlayerMove result;
+        if (think_(player_, startFen.c_str(), history.c_str(), limits.depth,
+                   static_cast<unsigned long long>(limits.nodes), limits.moveTimeMs,
+                   moveText, sizeof(moveText), &score) == 0) {
+            result.move = parseUciMove(board, moveText);
+            result.score = score;
+        }
+        return result;
+    }
+
+private:
+    void* library_ = nullptr;
+    void* player_ = nullptr;
+    ChessPluginDestroyFn destroy_ = nullptr;
+    ChessPluginNewGameFn newGame_ = nullptr;
+    ChessPluginThinkFn think_ = nullptr;
+};
+#endif
+
+bool parseFlag(const std::string& value, bool& flag) {
+    if (value == "1" || value == "on" || value == "true") {
+        flag = true;
+        return true;
+    }
+    if (value == "0" || value == "off" || value == "false") {
+        flag = false;
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+
+bool parsePlayerConfig(const std::string& text, PlayerConfig& config, std::string& error) {
+    config.options = text;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (item.empty()) continue;
+        size_t eq = item.find('=');
+        if (eq == std::string::npos) {
+            error = "ожидается ключ=значение: " + item;
+            return false;
+        }
+        std::string key = item.substr(0, eq);
+        std::string value = item.substr(eq + 1);
+
+        bool ok = true;
+        try {
+            if (key == "name") {
+                config.name = value;
+            } else if (key == "backend") {
+                config.backend = value;
+                ok = (value == "alphabeta" || value == "mcts");
+            } else if (key == "plugin") {
+                config.pluginPath = value;
+            } else if (key == "nnue") {
+                config.nnuePath = value;
+            } else if (key == "depth") {
+                config.depth = std::stoi(value);
+            } else if (key == "hash") {
+                config.hashMb = static_cast<size_t>(std::stoul(value));
+            } else if (key == "threads") {
+                config.threads = std::max(1, std::stoi(value));
+            } else if (key == "lmr") {
+                ok = parseFlag(value, config.params.lmrEnabled);
+            } else if (key == "lmp") {
+                ok = parseFlag(value, config.params.lmpEnabled);
+            } else if (key == "futility") {
+                ok = parseFlag(value, config.params.futilityEnabled);
+            } else if (key == "delta") {
+                ok = parseFlag(value, config.params.deltaPruningEnabled);
+            } else if (key == "lazy") {
+                ok = parseFlag(value, config.params.lazyEvalEnabled);
+            } else {
+                error = "неизвестная настройка движка: " + key;
+                return false;
+            }
+        } catch (...) {
+            ok = false;
+        }
+        if (!ok) {
+            error = "неверное значение настройки " + key + ": " + value;
+            return false;
+        }
+    }
+    if (config.name.empty()) {
+        config.name = config.pluginPath.empty() ? config.backend : config.pluginPath;
+    }
+    return true;
+}
+
+std::unique_ptr<Player> createPlayer(const PlayerConfig& config, std::string& error) {
+    if (!config.pluginPath.empty()) {
+#ifdef CHESS_MATCH_HAVE_DLOPEN
+        auto player = std::make_unique<PluginPlayer>();
+        if (!player->load(config, error)) {
+            return nullptr;
+        }
+        return player;
+#else
+        error = "плагины не поддерживаются на этой платформе";
+        return nullptr;
+#endif
+    }
+    if (config.backend == "mcts") {
+        return std::make_unique<MctsPlayer>(config);
+    }
+    std::shared_ptr<const AI::Nnue::Network> network;
+    if (!config.nnuePath.empty()) {
+        network = loadNetwork(config.nnuePath, error);
+        if (!network) {
+            return nullptr;
+        }
+    }
+    return std::make_unique<EnginePlayer>(config, std::move(network));
+}
+
+std::string moveToUci(const Move& move) {
+    std::string text = squareToString(move.from()) + squareToString(move.to());
+    switch (move.promotion()) {
+        case PieceType::Queen:  text += 'q'; break;
+        case PieceType::Rook:   text += 'r'; break;
+        case PieceType::Bishop: text += 'b'; break;
+        case PieceType::Knight: text += 'n'; break;
+        default: break;
+    }
+    return text;
+}
+
+Move parseUciMove(const Board& board, const std::string& text) {
+    MoveGenerator generator(board);
+    for (const Move& move : generator.generateLegalMoves(board.position().sideToMove())) {
+        if (moveToUci(move) == text) {
+            return move;
+        }
+    }
+    return Move();
+}
+
+}} // namespace Chess::Match
@@ -0,0 +1,106 @@
+#include "match/Sprt.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+namespace Chess {
+namespace Match {
+
+namespace {
+
+// Ожидаемая доля очков при разнице elo и обратное преобразование
+double eloToScore(double elo) {
+    return 1.0 / (1.0 + std::pow(10.0, -elo / 400.0));
+}
+
+double scoreToElo(double score) {
+    score = std::min(std::max(score, 1e-6), 1.0 - 1e-6);
+    return -400.0 * std::log10(1.0 / score - 1.0);
+}
+
+// Дисперсия результата одной партии
+double perGameVariance(const MatchScore& score) {
+    double n = score.games();
+    double s = score.scoreRatio();
+    double w = score.wins / n;
+    double d = score.draws / n;
+    double l = score.losses / n;
+    return w * (1.0 - s) * (1.0 - s) + d * (0.5 - s) * (0.5 - s) + l * s * s;
+}
+
+} // namespace
+
+double MatchScore::scoreRatio() const {
+    int n = games();
+    return n > 0 ? (wins + 0.5 * draws) / n : 0.5;
+}
+
+EloEstimate estimateElo(const MatchScore& score) {
+    EloEstimate estimate;
+    int n = score.games();
+    if (n == 0) {
+        return estimate;
+    }
+    
+    double s = score.scoreRatio();
+    double deviation = std::sqrt(perGameVariance(score) / n);
+    estimate.elo = scoreToElo(s);
+    estimate.errorMargin = (scoreToElo(s + 1.96 * deviation) - scoreToElo(s - 1.96 * deviation)) / 2.0;
+    
+    int decisive = score.wins + score.losses;
+    if (decisive > 0) {
+        estimate.los = 0.5 * (1.0 + std::erf((score.wins - score.losses) / std::sqrt(2.0 * decisive)));
+    }
+    return estimate;
+}
+
+Sprt::Sprt(double elo0, double elo1, double alpha, double beta)
+    : elo0_(elo0), elo1_(elo1),
+      lowerBound_(std::log(beta / (1.0 - alpha))),
+      upperBound_(std::log((1.0 - beta) / alpha)) {}
+
+double Sprt::llr(const MatchScore& score) const {
+    int n = score.games();
+    if (n == 0 || score.wins + score.losses == 0 || score.draws == n) {
+        return 0.0;  // Дисперсия вырождена - данных для решения нет
+    }
+    double variance = perGameVariance(score) / n;
+    if (variance <= 0.0) {
+        return 0.0;
+    }
+    double s = score.scoreRatio();
+    double s0 = eloToScore(elo0_);
+    double s1 = eloToScore(elo1_);
+    return (s1 - s0) * (2.0 * s - s0 - s1) / (2.0 * variance);
+}
+
+Sprt::Decision Sprt::decide(const MatchScore& score) const {
+    double value = llr(score);
+    if (value >= upperBound_) {
+        return Decision::AcceptH1;
+    }
+    if (value <= lowerBound_) {
+        return Decision::AcceptH0;
+    }
+    return Decision::Continue;
+}
+
+std::string formatProgress(const MatchScore& score, const Sprt* sprt) {
+    EloEstimate estimate = estimateElo(score);
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(1)
+       << "Партий " << score.games()
+       << ": +" << score.wins << " =" << score.draws << " -" << score.losses
+       << " | Elo " << estimate.elo << " ± " << estimate.errorMargin
+       << " | LOS " << estimate.los * 100.0 << "%";
+    if (sprt) {
+        ss << std::setprecision(2)
+           << " | LLR " << sprt->llr(score)
+           << " (" << sprt->lowerBound() << ", " << sprt->upperBound() << ")"
+           << " [" << sprt->elo0() << ", " << sprt->elo1() << "]";
+    }
+    return ss.str();
+}
+
+}} // namespace Chess::Match
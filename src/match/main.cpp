@@ -0,0 +1,126 @@
+#include "match/MatchRunner.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+using namespace Chess::Match;
+
+namespace {
+
+void printUsage() {
+    std::cout <<
+        "chess-match - матч двух движков без GUI\n"
+        "\n"
+        "  --engine1 НАСТРОЙКИ      первый движок: name=new,depth=6,hash=16,lmr=0,\n"
+        "  --engine2 НАСТРОЙКИ      backend=alphabeta|mcts, nnue=сеть или plugin=путь.so\n"
+        "  --games N                максимум партий (по умолчанию 1000)\n"
+        "  --concurrency N          партий одновременно (по умолчанию - число CPU)\n"
+        "  --openings ФАЙЛ          дебюты: FEN или EPD, по позиции в строке\n"
+        "  --depth D | --nodes N | --movetime MS    лимит на ход\n"
+        "  --tc БАЗА+ДОБАВКА        часы в секундах, например 10+0.1\n"
+        "  --sprt ELO0 ELO1 [ALPHA BETA]            остановка по SPRT\n"
+        "  --resign ОЦЕНКА ХОДОВ    адъюдикация победы (по умолчанию 1000 3)\n"
+        "  --draw ХОД ОЦЕНКА ХОДОВ  адъюдикация ничьей (по умолчанию 40 10 8)\n"
+        "  --maxplies N             предел длины партии (по умолчанию 400)\n"
+        "  --report N               прогресс каждые N партий (по умолчанию 10)\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    PlayerConfig configs[2];
+    MatchOptions options;
+    options.concurrency = std::max(1u, std::thread::hardware_concurrency());
+    std::string openingsPath;
+    std::string error;
+    bool haveEngine[2] = {false, false};
+
+    // Берет очередной аргумент; false, если аргументы кончились
+    int i = 1;
+    auto next = [&](std::string& value) {
+        if (i + 1 >= argc) return false;
+        value = argv[++i];
+        return true;
+    };
+
+    try {
+        for (; i < argc; ++i) {
+            std::string arg = argv[i];
+            std::string value;
+            if (arg == "--help" || arg == "-h") {
+                printUsage();
+                return 0;
+            } else if (arg == "--engine1" || arg == "--engine2") {
+                int index = (arg == "--engine1") ? 0 : 1;
+                if (!next(value) || !parsePlayerConfig(value, configs[index], error)) {
+                    std::cerr << arg << ": " << (error.empty() ? "нет настроек" : error) << std::endl;
+                    return 1;
+                }
+                haveEngine[index] = true;
+            } else if (arg == "--games" && next(value)) {
+                options.maxGames = std::stoi(value);
+            } else if (arg == "--concurrency" && next(value)) {
+                options.concurrency = std::stoi(value);
+            } else if (arg == "--openings" && next(value)) {
+                openingsPath = value;
+            } else if (arg == "--depth" && next(value)) {
+                options.limits.depth = std::stoi(value);
+            } else if (arg == "--nodes" && next(value)) {
+                options.limits.nodes = std::stoull(value);
+            } else if (arg == "--movetime" && next(value)) {
+                options.limits.moveTimeMs = std::stoi(value);
+            } else if (arg == "--tc" && next(value)) {
+                size_t plus = value.find('+');
+                options.baseTimeMs = static_cast<int>(std::stod(value.substr(0, plus)) * 1000.0);
+                if (plus != std::string::npos) {
+                    options.incrementMs = static_cast<int>(std::stod(value.substr(plus + 1)) * 1000.0);
+                }
+            } else if (arg == "--sprt" && i + 2 < argc) {
+                options.sprtEnabled = true;
+                options.elo0 = std::stod(argv[++i]);
+                options.elo1 = std::stod(argv[++i]);
+                if (i + 2 < argc && argv[i + 1][0] != '-') {
+                    options.alpha = std::stod(argv[++i]);
+                    options.beta = std::stod(argv[++i]);
+                }
+            } else if (arg == "--resign" && i + 2 < argc) {
+                options.resignScore = std::stoi(argv[++i]);
+                options.resignMoves = std::stoi(argv[++i]);
+            } else if (arg == "--draw" && i + 3 < argc) {
+                options.drawMoveNumber = std::stoi(argv[++i]);
+                options.drawScore = std::stoi(argv[++i]);
+                options.drawMoves = std::stoi(argv[++i]);
+            } else if (arg == "--maxplies" && next(value)) {
+                options.maxPlies = std::stoi(value);
+            } else if (arg == "--report" && next(value)) {
+                options.reportEvery = std::max(1, std::stoi(value));
+            } else {
+                std::cerr << "Неизвестный или неполный аргумент: " << arg << std::endl;
+                printUsage();
+                return 1;
+            }
+        }
+    } catch (const std::exception&) {
+        std::cerr << "Неверное число в аргументах" << std::endl;
+        return 1;
+    }
+
+    if (!haveEngine[0] || !haveEngine[1]) {
+        printUsage();
+        return 1;
+    }
+    if (!openingsPath.empty() && !MatchRunner::loadOpenings(openingsPath, options.openings, error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+
+    MatchRunner runner(configs[0], configs[1], options);
+    MatchScore score;
+    if (!runner.run(std::cout, score, error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    return 0;
+}
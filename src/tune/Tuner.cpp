@@ -0,0 +1,476 @@
+#include "tune/Tuner.h"
+#include "ai/Endgame.h"
+#include "ai/Evaluator.h"
+#include "ai/PawnHashTable.h"
+#include "ai/Score.h"
+#include "core/Board.h"
+#include "core/MoveGenerator.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <future>
+#include <iomanip>
+#include <sstream>
+
+namespace Chess {
+namespace Tune {
+
+using AI::EvalParams;
+using AI::PhaseScore;
+
+namespace {
+
+constexpr size_t BATCH_SIZE = 1 << 16;          // Строк файла на один параллельный проход
+constexpr int MAX_QUIESCENCE_PLY = 32;
+constexpr int DELTA_MARGIN = 200;               // Взятие, не поднимающее оценку до alpha даже с запасом
+constexpr double LN10 = 2.302585092994046;
+
+// Adam
+constexpr double ADAM_BETA1 = 0.9;
+constexpr double ADAM_BETA2 = 0.999;
+constexpr double ADAM_EPSILON = 1e-8;
+
+// Результат из хвоста строки после полей позиции: 0 - победа черных,
+// 1 - ничья, 2 - победа белых, -1 - не найден
+int parseResult(const std::string& text) {
+    if (text.find("1/2") != std::string::npos || text.find("0.5") != std::string::npos) return 1;
+    if (text.find("1-0") != std::string::npos || text.find("1.0") != std::string::npos) return 2;
+    if (text.find("0-1") != std::string::npos || text.find("0.0") != std::string::npos) return 0;
+    return -1;
+}
+
+// Строка EPD/FEN -> FEN и результат
+bool parseLine(const std::string& line, std::string& fen, int& result) {
+    std::istringstream ss(line);
+    std::string fields[4];
+    for (std::string& field : fields) {
+        if (!(ss >> field)) return false;
+    }
+    fen = fields[0] + " " + fields[1] + " " + fields[2] + " " + fields[3];
+
+    // Счетчики ходов FEN - если они есть; иначе сразу операции EPD
+    std::string rest;
+    std::getline(ss, rest);
+    std::istringstream counters(rest);
+    std::string halfmove, fullmove;
+    if (counters >> halfmove >> fullmove &&
+        std::all_of(halfmove.begin(), halfmove.end(), ::isdigit) &&
+        std::all_of(fullmove.begin(), fullmove.end(), ::isdigit)) {
+        fen += " " + halfmove + " " + fullmove;
+        std::getline(counters, rest);
+    } else {
+        fen += " 0 1";
+    }
+    result = parseResult(rest);
+    return result >= 0;
+}
+
+int sideScore(const Board& board, AI::PawnHashTable& pawnTable, Color side) {
+    int score = AI::Evaluator(board, &pawnTable).evaluate();
+    return (side == Color::White) ? score : -score;
+}
+
+int victimValue(const Board& board, const Move& move) {
+    return move.isEnPassant() ? 100 : board.pieceAt(move.to()).value();
+}
+
+int captureOrder(const Board& board, const Move& move) {
+    // MVV-LVA
+    return victimValue(board, move) * 16 - board.pieceAt(move.from()).value() / 100;
+}
+
+// Quiescence со стоячей оценкой и только взятиями; pv - путь к спокойному листу
+int quiesce(Board& board, AI::PawnHashTable& pawnTable, int alpha, int beta, int ply,
+            std::vector<Move>& pv) {
+    pv.clear();
+    Color side = board.position().sideToMove();
+    int standPat = sideScore(board, pawnTable, side);
+    if (standPat >= beta || ply >= MAX_QUIESCENCE_PLY) {
+        return standPat;
+    }
+    alpha = std::max(alpha, standPat);
+
+    MoveGenerator generator(board);
+    std::vector<Move> captures = generator.generateCaptures(side);
+    std::sort(captures.begin(), captures.end(), [&board](const Move& a, const Move& b) {
+        return captureOrder(board, a) > captureOrder(board, b);
+    });
+
+    std::vector<Move> childPv;
+    for (const Move& move : captures) {
+        if (!move.isPromotion() && standPat + victimValue(board, move) + DELTA_MARGIN <= alpha) {
+            continue;
+        }
+        board.makeMove(move);
+        int score = -quiesce(board, pawnTable, -beta, -alpha, ply + 1, childPv);
+        board.unmakeMove(move);
+        if (score > alpha) {
+            alpha = score;
+            pv.assign(1, move);
+            pv.insert(pv.end(), childPv.begin(), childPv.end());
+            if (alpha >= beta) break;
+        }
+    }
+    return alpha;
+}
+
+std::string formatWeight(const PhaseScore& weight) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "{%4d,%4d}", weight.mg, weight.eg);
+    return buffer;
+}
+
+std::string formatWeights(const PhaseScore* weights, int count) {
+    std::string text = "{";
+    for (int i = 0; i < count; ++i) {
+        text += (i > 0 ? ", " : "") + formatWeight(weights[i]);
+    }
+    return text + "}";
+}
+
+} // namespace
+
+Tuner::Tuner(const TuneOptions& options) : options_(options) {
+    options_.threads = std::max(1, options_.threads);
+}
+
+bool Tuner::load(const std::string& path, std::ostream& out, std::string& error) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        error = "не удалось открыть файл позиций " + path;
+        return false;
+    }
+    auto startTime = std::chrono::steady_clock::now();
+    positions_.clear();
+    coefficients_.clear();
+
+    // Итог разбора части строк одним потоком
+    struct Chunk {
+        std::vector<Position> positions;            // first - внутри coefficients чанка
+        std::vector<Coefficient> coefficients;
+        size_t skipped = 0;
+        size_t mismatches = 0;
+    };
+
+    auto parseChunk = [this](const std::vector<std::string>& lines, size_t begin, size_t end, Chunk& chunk) {
+        Board board;
+        AI::PawnHashTable pawnTable;
+        std::vector<Move> pv;
+        for (size_t i = begin; i < end; ++i) {
+            std::string fen;
+            int result = -1;
+            if (!parseLine(lines[i], fen, result)) {
+                chunk.skipped++;
+                continue;
+            }
+            // Доска одна на чанк: ходы прошлых листов quiescence ей не нужны
+            board.setFromFEN(fen);
+            board.clearHistory();
+            Color side = board.position().sideToMove();
+            if (board.findKing(Color::White) == 255 || board.findKing(Color::Black) == 255 ||
+                board.isCheck(oppositeColor(side))) {
+                chunk.skipped++;
+                continue;
+            }
+
+            // Оценка должна описывать позицию без висящих взятий; под шахом
+            // спокойного листа нет - такие позиции пропускаются
+            if (options_.quiesce) {
+                if (board.isCheck(side)) {
+                    chunk.skipped++;
+                    continue;
+                }
+                quiesce(board, pawnTable, -AI::SCORE_INFINITY, AI::SCORE_INFINITY, 0, pv);
+                for (const Move& move : pv) {
+                    board.makeMove(move);
+                }
+            }
+
+            // Особые эндшпили оцениваются не по EvalParams - учить по ним нечему.
+            // Масштаб эндшпиля (разноцветные слоны, сторона без пешек) учитывается
+            // ниже: разложение его не содержит, а движок его применяет.
+            const AI::Endgames::Entry* endgame = AI::Endgames::probe(board);
+            if (endgame && endgame->evaluate) {
+                chunk.skipped++;
+                continue;
+            }
+
+            AI::EvalTrace trace;
+            AI::Evaluator evaluator(board);
+            evaluator.setTrace(&trace);
+            int eval = evaluator.evaluate();
+
+            Position position;
+            position.first = static_cast<uint32_t>(chunk.coefficients.size());
+            position.phase = static_cast<uint8_t>(board.gamePhase());
+            position.result = static_cast<uint8_t>(result);
+
+            // Разложение обязано давать ту же оценку: иначе в Evaluator есть
+            // слагаемое мимо EvalParams, и тюнер его не видит
+            int64_t mg = 0;
+            int64_t eg = 0;
+            for (int index = 0; index < EvalParams::SIZE; ++index) {
+                int value = trace.coeffs[index];
+                if (value == 0) continue;
+                chunk.coefficients.push_back({static_cast<uint16_t>(index), static_cast<int16_t>(value)});
+                mg += value * AI::DEFAULT_EVAL_PARAMS.data()[index].mg;
+                eg += value * AI::DEFAULT_EVAL_PARAMS.data()[index].eg;
+            }
+            int64_t traced = (mg * position.phase + eg * (Board::PHASE_MAX - position.phase)) / Board::PHASE_MAX;
+            if (traced != eval) {
+                chunk.mismatches++;
+            }
+            position.count = static_cast<uint16_t>(chunk.coefficients.size() - position.first);
+            // Сильная сторона - как в Evaluator: по знаку эндшпильной части
+            Color strong = (eg > 0) ? Color::White : Color::Black;
+            position.scale = static_cast<uint8_t>(endgame ? endgame->scale(board, strong)
+                                                          : AI::Endgames::SCALE_NORMAL);
+            chunk.positions.push_back(position);
+        }
+    };
+
+    size_t lineCount = 0;
+    size_t skipped = 0;
+    size_t mismatches = 0;
+    std::vector<std::string> lines;
+    std::string line;
+    bool more = true;
+    while (more) {
+        lines.clear();
+        while (lines.size() < BATCH_SIZE && (more = static_cast<bool>(std::getline(file, line)))) {
+            if (line.empty() || line[0] == '#') continue;
+            lines.push_back(line);
+        }
+        lineCount += lines.size();
+
+        std::vector<Chunk> chunks(options_.threads);
+        size_t perThread = (lines.size() + options_.threads - 1) / options_.threads;
+        std::vector<std::future<void>> futures;
+        for (int t = 0; t < options_.threads; ++t) {
+            size_t begin = std::min(lines.size(), t * perThread);
+            size_t end = std::min(lines.size(), begin + perThread);
+            futures.push_back(std::async(std::launch::async, parseChunk, std::cref(lines), begin, end,
+                                         std::ref(chunks[t])));
+        }
+        for (auto& future : futures) {
+            future.get();
+        }
+
+        for (Chunk& chunk : chunks) {
+            skipped += chunk.skipped;
+            mismatches += chunk.mismatches;
+            uint32_t offset = static_cast<uint32_t>(coefficients_.size());
+            for (Position position : chunk.positions) {
+                position.first += offset;
+                positions_.push_back(position);
+            }
+            coefficients_.insert(coefficients_.end(), chunk.coefficients.begin(), chunk.coefficients.end());
+        }
+        if (options_.maxPositions > 0 && positions_.size() >= options_.maxPositions) {
+            // Коэффициенты отброшенных позиций лежат в хвосте - отрезаем и их
+            positions_.resize(options_.maxPositions);
+            coefficients_.resize(positions_.back().first + positions_.back().count);
+            break;
+        }
+    }
+    positions_.shrink_to_fit();
+    coefficients_.shrink_to_fit();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    double megabytes = (positions_.size() * sizeof(Position) + coefficients_.size() * sizeof(Coefficient)) /
+                       (1024.0 * 1024.0);
+    out << "Позиций: " << positions_.size() << " из " << lineCount << " строк (пропущено " << skipped
+        << "), " << std::fixed << std::setprecision(1) << megabytes << " МБ, "
+        << std::setprecision(2) << seconds << " с" << std::endl;
+    if (mismatches > 0) {
+        out << "Внимание: у " << mismatches << " позиций разложение не совпало с оценкой" << std::endl;
+    }
+    if (positions_.empty()) {
+        error = "в файле " + path + " нет позиций с результатом";
+        return false;
+    }
+    return true;
+}
+
+std::vector<double> Tuner::flatten(const EvalParams& params) {
+    std::vector<double> weights(2 * EvalParams::SIZE);
+    for (int i = 0; i < EvalParams::SIZE; ++i) {
+        weights[2 * i] = params.data()[i].mg;
+        weights[2 * i + 1] = params.data()[i].eg;
+    }
+    return weights;
+}
+
+double Tuner::evaluateError(const std::vector<double>& weights, double k, std::vector<double>* gradient) const {
+    int threads = options_.threads;
+    size_t perThread = (positions_.size() + threads - 1) / threads;
+    std::vector<std::vector<double>> gradients(gradient ? threads : 0, std::vector<double>(weights.size(), 0.0));
+
+    auto worker = [&](int t) {
+        size_t begin = std::min(positions_.size(), t * perThread);
+        size_t end = std::min(positions_.size(), begin + perThread);
+        double* localGradient = gradient ? gradients[t].data() : nullptr;
+        double sum = 0.0;
+        for (size_t i = begin; i < end; ++i) {
+            const Position& position = positions_[i];
+            const Coefficient* coefficient = &coefficients_[position.first];
+            double mgWeight = static_cast<double>(position.phase) / Board::PHASE_MAX;
+            double egWeight = (1.0 - mgWeight) * position.scale / AI::Endgames::SCALE_NORMAL;
+
+            double mg = 0.0;
+            double eg = 0.0;
+            for (int c = 0; c < position.count; ++c) {
+                mg += coefficient[c].value * weights[2 * coefficient[c].index];
+                eg += coefficient[c].value * weights[2 * coefficient[c].index + 1];
+            }
+            double eval = mg * mgWeight + eg * egWeight;
+            double sigmoid = 1.0 / (1.0 + std::exp(-k * eval * LN10 / 400.0));
+            double diff = position.result * 0.5 - sigmoid;
+            sum += diff * diff;
+
+            if (localGradient) {
+                double slope = -2.0 * diff * sigmoid * (1.0 - sigmoid) * k * LN10 / 400.0;
+                for (int c = 0; c < position.count; ++c) {
+                    localGradient[2 * coefficient[c].index] += slope * coefficient[c].value * mgWeight;
+                    localGradient[2 * coefficient[c].index + 1] += slope * coefficient[c].value * egWeight;
+                }
+            }
+        }
+        return sum;
+    };
+
+    std::vector<std::future<double>> futures;
+    for (int t = 1; t < threads; ++t) {
+        futures.push_back(std::async(std::launch::async, worker, t));
+    }
+    double sum = worker(0);
+    for (auto& future : futures) {
+        sum += future.get();
+    }
+
+    double count = static_cast<double>(positions_.size());
+    if (gradient) {
+        gradient->assign(weights.size(), 0.0);
+        for (const std::vector<double>& local : gradients) {
+            for (size_t i = 0; i < weights.size(); ++i) {
+                (*gradient)[i] += local[i] / count;
+            }
+        }
+    }
+    return sum / count;
+}
+
+double Tuner::error(const EvalParams& params, double k) const {
+    return evaluateError(flatten(params), k, nullptr);
+}
+
+double Tuner::findK(const EvalParams& params) const {
+    // Ошибка по K унимодальна - золотое сечение
+    std::vector<double> weights = flatten(params);
+    const double ratio = (std::sqrt(5.0) - 1.0) / 2.0;
+    double low = 0.05;
+    double high = 5.0;
+    double a = high - ratio * (high - low);
+    double b = low + ratio * (high - low);
+    double errorA = evaluateError(weights, a, nullptr);
+    double errorB = evaluateError(weights, b, nullptr);
+    while (high - low > 0.001) {
+        if (errorA < errorB) {
+            high = b;
+            b = a;
+            errorB = errorA;
+            a = high - ratio * (high - low);
+            errorA = evaluateError(weights, a, nullptr);
+        } else {
+            low = a;
+            a = b;
+            errorA = errorB;
+            b = low + ratio * (high - low);
+            errorB = evaluateError(weights, b, nullptr);
+        }
+    }
+    return (low + high) / 2.0;
+}
+
+void Tuner::tune(EvalParams& params, std::ostream& out) {
+    auto startTime = std::chrono::steady_clock::now();
+    std::vector<double> weights = flatten(params);
+    double k = (options_.k > 0.0) ? options_.k : findK(params);
+    out << std::fixed << std::setprecision(4) << "K = " << k << ", начальная ошибка "
+        << std::setprecision(6) << evaluateError(weights, k, nullptr) << std::endl;
+
+    // Adam: у параметров, которые не встречаются в данных, градиент нулевой -
+    // они остаются как были
+    std::vector<double> gradient;
+    std::vector<double> momentum(weights.size(), 0.0);
+    std::vector<double> velocity(weights.size(), 0.0);
+    for (int epoch = 1; epoch <= options_.epochs; ++epoch) {
+        double currentError = evaluateError(weights, k, &gradient);
+        double correction1 = 1.0 - std::pow(ADAM_BETA1, epoch);
+        double correction2 = 1.0 - std::pow(ADAM_BETA2, epoch);
+        for (size_t i = 0; i < weights.size(); ++i) {
+            momentum[i] = ADAM_BETA1 * momentum[i] + (1.0 - ADAM_BETA1) * gradient[i];
+            velocity[i] = ADAM_BETA2 * velocity[i] + (1.0 - ADAM_BETA2) * gradient[i] * gradient[i];
+            weights[i] -= options_.learningRate * (momentum[i] / correction1) /
+                          (std::sqrt(velocity[i] / correction2) + ADAM_EPSILON);
+        }
+
+        if (epoch % options_.reportEvery == 0 || epoch == options_.epochs) {
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+            out << "Эпоха " << epoch << ": ошибка " << std::setprecision(6) << currentError
+                << " (" << std::setprecision(1) << seconds << " с)" << std::endl;
+        }
+    }
+
+    for (int i = 0; i < EvalParams::SIZE; ++i) {
+        params.data()[i].mg = static_cast<int>(std::lround(weights[2 * i]));
+        params.data()[i].eg = static_cast<int>(std::lround(weights[2 * i + 1]));
+    }
+    out << "Итоговая ошибка " << std::setprecision(6) << error(params, k) << std::endl;
+}
+
+void Tuner::writeSource(const EvalParams& params, std::ostream& out) {
+    static const char* PIECE_NAMES[6] = {"Пешка", "Конь", "Слон", "Ладья", "Ферзь", "Король"};
+
+    out << "#include \"ai/EvalParams.h\"\n\n"
+        << "namespace Chess {\nnamespace AI {\n\n"
+        << "// Файл в этом формате печатает chess-tune: настроенные параметры заменяют его целиком.\n"
+        << "const EvalParams DEFAULT_EVAL_PARAMS = {\n"
+        << "    // Материал: пешка, конь, слон, ладья, ферзь, король\n"
+        << "    " << formatWeights(params.material, 6) << ",\n\n"
+        << "    // Piece-Square Tables со стороны белых, первая строка - 8-я горизонталь\n"
+        << "    {\n";
+    for (int type = 0; type < 6; ++type) {
+        out << "        // " << PIECE_NAMES[type] << "\n"
+            << "        {\n";
+        for (int row = 0; row < 8; ++row) {
+            out << "            ";
+            for (int file = 0; file < 8; ++file) {
+                out << formatWeight(params.psqt[type][row * 8 + file]) << (file < 7 ? ", " : "");
+            }
+            out << (row < 7 ? ",\n" : "\n");
+        }
+        out << "        }" << (type < 5 ? ",\n" : "\n");
+    }
+    out << "    },\n\n"
+        << "    // Сдвоенная и изолированная пешка\n"
+        << "    " << formatWeight(params.doubledPawn) << ",\n"
+        << "    " << formatWeight(params.isolatedPawn) << ",\n\n"
+        << "    // Проходная пешка по горизонтали\n"
+        << "    " << formatWeights(params.passedPawn, 8) << ",\n\n"
+        << "    // Пешечный щит и полуоткрытая вертикаль у короля\n"
+        << "    " << formatWeight(params.pawnShield) << ",\n"
+        << "    " << formatWeight(params.kingSemiOpenFile) << ",\n\n"
+        << "    // Ладья на открытой и полуоткрытой вертикали, конь на форпосте\n"
+        << "    " << formatWeight(params.rookOpenFile) << ",\n"
+        << "    " << formatWeight(params.rookSemiOpenFile) << ",\n"
+        << "    " << formatWeight(params.knightOutpost) << ",\n\n"
+        << "    // Подвижность: конь, слон, ладья, ферзь\n"
+        << "    " << formatWeights(params.mobility, 4) << "\n"
+        << "};\n\n"
+        << "}} // namespace Chess::AI\n";
+}
+
+}} // namespace Chess::Tune
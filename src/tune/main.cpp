@@ -0,0 +1,109 @@
+#include "tune/Tuner.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+
+using namespace Chess;
+using namespace Chess::Tune;
+
+namespace {
+
+void printUsage() {
+    std::cout <<
+        "chess-tune - Texel-тюнинг параметров оценки\n"
+        "\n"
+        "  chess-tune ФАЙЛ [настройки]   ФАЙЛ - EPD/FEN с результатами партий\n"
+        "  --threads N              потоков (по умолчанию - число CPU)\n"
+        "  --positions N            взять первые N позиций\n"
+        "  --epochs N               эпох градиентного спуска (по умолчанию 1000)\n"
+        "  --rate ШАГ               шаг Adam в сантипешках (по умолчанию 1.0)\n"
+        "  --k K                    масштаб сигмоиды (по умолчанию подбирается)\n"
+        "  --no-quiesce             оценивать позиции как есть, без quiescence\n"
+        "  --report N               ошибка каждые N эпох (по умолчанию 50)\n"
+        "  --output ФАЙЛ            куда записать EvalParams.cpp (по умолчанию stdout)\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    TuneOptions options;
+    options.threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    std::string positionsPath;
+    std::string outputPath;
+
+    // Берет очередной аргумент; false, если аргументы кончились
+    int i = 1;
+    auto next = [&](std::string& value) {
+        if (i + 1 >= argc) return false;
+        value = argv[++i];
+        return true;
+    };
+
+    try {
+        for (; i < argc; ++i) {
+            std::string arg = argv[i];
+            std::string value;
+            if (arg == "--help" || arg == "-h") {
+                printUsage();
+                return 0;
+            } else if (arg == "--threads" && next(value)) {
+                options.threads = std::max(1, std::stoi(value));
+            } else if (arg == "--positions" && next(value)) {
+                options.maxPositions = static_cast<size_t>(std::stoull(value));
+            } else if (arg == "--epochs" && next(value)) {
+                options.epochs = std::max(0, std::stoi(value));
+            } else if (arg == "--rate" && next(value)) {
+                options.learningRate = std::stod(value);
+            } else if (arg == "--k" && next(value)) {
+                options.k = std::stod(value);
+            } else if (arg == "--no-quiesce") {
+                options.quiesce = false;
+            } else if (arg == "--report" && next(value)) {
+                options.reportEvery = std::max(1, std::stoi(value));
+            } else if (arg == "--output" && next(value)) {
+                outputPath = value;
+            } else if (arg[0] != '-' && positionsPath.empty()) {
+                positionsPath = arg;
+            } else {
+                std::cerr << "Неизвестный или неполный аргумент: " << arg << std::endl;
+                printUsage();
+                return 1;
+            }
+        }
+    } catch (const std::exception&) {
+        std::cerr << "Неверное число в аргументах" << std::endl;
+        return 1;
+    }
+
+    if (positionsPath.empty()) {
+        printUsage();
+        return 1;
+    }
+
+    // Прогресс - в stderr, если исходник параметров идет в stdout
+    std::ostream& log = outputPath.empty() ? std::cerr : std::cout;
+    Tuner tuner(options);
+    std::string error;
+    if (!tuner.load(positionsPath, log, error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+
+    AI::EvalParams params = AI::DEFAULT_EVAL_PARAMS;
+    tuner.tune(params, log);
+
+    if (outputPath.empty()) {
+        Tuner::writeSource(params, std::cout);
+    } else {
+        std::ofstream output(outputPath);
+        if (!output.is_open()) {
+            std::cerr << "не удалось записать " << outputPath << std::endl;
+            return 1;
+        }
+        Tuner::writeSource(params, output);
+        log << "Параметры записаны в " << outputPath << std::endl;
+    }
+    return 0;
+}
@@ -5,11 +5,22 @@
 #include <QHBoxLayout>
 #include <QMessageBox>
 #include <QTimer>
+#include <QSignalBlocker>
+#include <QStringList>
 #include <QDebug>
+#include <algorithm>
 
 namespace Chess {
 namespace UI {
 
+namespace {
+// Время на ход AI (миллисекунды)
+constexpr int AI_MOVE_TIME_MS = 1500;
+// Период снимков анализа и опроса канала из GUI (миллисекунды)
+constexpr int ANALYSIS_INTERVAL_MS = 250;
+constexpr int ANALYSIS_POLL_MS = 100;
+} // namespace
+
 MainWindow::MainWindow(QWidget* parent)
     : QMainWindow(parent),
       playingAgainstAi_(true),
@@ -24,6 +35,10 @@ MainWindow::MainWindow(QWidget* parent)
     aiEngine_->setDifficulty(3); // Средняя сложность по умолчанию (было 2, но даже 3 быстрее чем старая 5)
     aiEngine_->setLogFile("chess_ai.log");  // Включаем логирование
     
+    ponderBoard_ = std::make_unique<Board>();
+    ponderEngine_ = std::make_unique<AI::Engine>(*ponderBoard_, aiEngine_->transpositionTable());
+    ponderEngine_->setLogFile("chess_ai.log");
+    
     setupUi();
     createMenuBar();
     connectSignals();
@@ -34,7 +49,10 @@ MainWindow::MainWindow(QWidget* parent)
     updateStatus();
 }
 
-MainWindow::~MainWindow() = default;
+MainWindow::~MainWindow() {
+    stopAnalysis();
+    stopPondering();
+}
 
 void MainWindow::setupUi() {
     setWindowTitle("Chess AI - Шахматы с AI");
@@ -58,6 +76,12 @@ void MainWindow::setupUi() {
     statusLabel_->setStyleSheet("font-size: 16px; font-weight: bold; padding: 10px;");
     sideLayout->addWidget(statusLabel_);
     
+    // Главный вариант последнего поиска AI
+    pvLabel_ = new QLabel(this);
+    pvLabel_->setWordWrap(true);
+    pvLabel_->setStyleSheet("font-size: 12px; color: gray; padding: 0 10px;");
+    sideLayout->addWidget(pvLabel_);
+    
     // Сложность AI
     QLabel* diffLabel = new QLabel("Сложность AI:", this);
     sideLayout->addWidget(diffLabel);
@@ -77,6 +101,13 @@ void MainWindow::setupUi() {
     undoButton_ = new QPushButton("Отменить ход", this);
     sideLayout->addWidget(undoButton_);
     
+    analysisButton_ = new QPushButton("Анализ позиции", this);
+    analysisButton_->setCheckable(true);
+    sideLayout->addWidget(analysisButton_);
+    
+    analysisTimer_ = new QTimer(this);
+    analysisTimer_->setInterval(ANALYSIS_POLL_MS);
+    
     // История ходов
     QLabel* movesLabel = new QLabel("История ходов:", this);
     sideLayout->addWidget(movesLabel);
@@ -118,18 +149,42 @@ void MainWindow::connectSignals() {
     connect(chessBoard_, &ChessBoard::squareClicked, this, &MainWindow::onSquareClicked);
     connect(newGameButton_, &QPushButton::clicked, this, &MainWindow::onNewGame);
     connect(undoButton_, &QPushButton::clicked, this, &MainWindow::onUndoMove);
+    connect(analysisButton_, &QPushButton::toggled, this, &MainWindow::onAnalysisToggled);
+    connect(analysisTimer_, &QTimer::timeout, this, &MainWindow::onAnalysisTimer);
     connect(difficultyCombo_, QOverload<int>::of(&QComboBox::currentIndexChanged),
             this, &MainWindow::onDifficultyChanged);
 }
 
 void MainWindow::onMoveRequested(const Move& move) {
+    stopAnalysis();
+    
+    // Игрок сделал предсказанный ход - пондеринг продолжается как обычный поиск
+    bool ponderHit = ponderFuture_.valid() && move == ponderMove_;
+    if (!ponderHit) {
+        stopPondering();
+    }
+    
     // ChessBoard уже проверил, что это фигура игрока и его ход
     makeMove(move);
     
     // Если играем против AI и теперь ход AI
     if (playingAgainstAi_ && board_->position().sideToMove() == aiColor_) {
+        if (ponderHit) {
+            statusLabel_->setText("AI думает...");
+            statusLabel_->repaint();
+            
+            ponderEngine_->ponderHit();
+            AI::SearchResult result = ponderFuture_.get();
+            qDebug() << "Ponderhit: ход" << QString::fromStdString(move.toLongAlgebraic()) << "был предсказан";
+            if (result.bestMove.isValid()) {
+                playAiMove(result);
+                return;
+            }
+        }
         // Небольшая задержка перед ходом AI
         QTimer::singleShot(300, this, &MainWindow::onAiMove);
+    } else {
+        stopPondering();
     }
 }
 
@@ -138,10 +193,13 @@ void MainWindow::onSquareClicked(Square sq) {
 }
 
 void MainWindow::onNewGame() {
+    stopAnalysis();
+    stopPondering();
     board_->setupInitialPosition();
     chessBoard_->clearHighlights();
     moveHistory_.clear();
     moveList_->clear();
+    pvLabel_->clear();
     
     // Показываем диалог выбора цвета
     showColorSelectionDialog();
@@ -180,6 +238,7 @@ void MainWindow::showColorSelectionDialog() {
 void MainWindow::onDifficultyChanged(int index) {
     // Легко=2, Средне=3, Сложно=4, Эксперт=5
     int depth = 2 + index;
+    stopPondering();
     aiEngine_->setDifficulty(depth);
     qDebug() << "Установлена сложность AI: глубина" << depth;
 }
@@ -187,6 +246,9 @@ void MainWindow::onDifficultyChanged(int index) {
 void MainWindow::onUndoMove() {
     if (moveHistory_.empty()) return;
     
+    stopAnalysis();
+    stopPondering();
+    
     Move lastMove = moveHistory_.back();
     board_->unmakeMove(lastMove);
     moveHistory_.pop_back();
@@ -208,6 +270,7 @@ void MainWindow::onAiMove() {
     if (!playingAgainstAi_ || board_->position().sideToMove() != aiColor_) {
         return;
     }
+    stopAnalysis();
     
     statusLabel_->setText("AI думает...");
     statusLabel_->repaint();
@@ -216,22 +279,130 @@ void MainWindow::onAiMove() {
     std::string fenBeforeSearch = board_->toFEN();
     
     // Используем ограничение по времени для быстрого ответа (1.5 секунды)
-    AI::SearchResult result = aiEngine_->findBestMoveWithTimeLimit(aiColor_, 1500);
+    AI::SearchResult result = aiEngine_->findBestMoveWithTimeLimit(aiColor_, AI_MOVE_TIME_MS);
     
     // Восстанавливаем состояние доски после поиска AI
     board_->setFromFEN(fenBeforeSearch);
     
+    playAiMove(result);
+}
+
+void MainWindow::playAiMove(const AI::SearchResult& result) {
     if (result.bestMove.isValid()) {
         makeMove(result.bestMove);
         
+        QStringList pvMoves;
+        for (const Move& move : result.pv) {
+            pvMoves << QString::fromStdString(move.toLongAlgebraic());
+        }
+        int mateMoves = AI::mateInMoves(result.score);
+        QString scoreText = (mateMoves != 0)
+            ? QString("мат в %1").arg(mateMoves)
+            : QString::number(result.score);
+        pvLabel_->setText(QString("Вариант AI (глубина %1/%2, оценка %3): %4")
+            .arg(result.depth)
+            .arg(result.selDepth)
+            .arg(scoreText)
+            .arg(pvMoves.join(' ')));
+        
         // Показываем информацию о поиске в консоли
-        qDebug() << QString("AI ход: %1 | глубина: %2 | оценка: %3 | узлов: %4 | время: %5с")
+        qDebug() << QString("AI ход: %1 | глубина: %2/%3 | оценка: %4 | узлов: %5 (quiescence: %6) | время: %7с | PV: %8")
             .arg(QString::fromStdString(result.bestMove.toLongAlgebraic()))
             .arg(result.depth)
+            .arg(result.selDepth)
             .arg(result.score)
             .arg(result.nodesSearched)
-            .arg(result.timeSpent, 0, 'f', 2);
+            .arg(result.quiescenceNodes)
+            .arg(result.timeSpent, 0, 'f', 2)
+            .arg(pvMoves.join(' '));
+        
+        startPondering(result);
+    }
+}
+
+void MainWindow::startPondering(const AI::SearchResult& result) {
+    // Ожидаемый ответ игрока - второй ход главного варианта
+    if (result.pv.size() < 2 || isGameOver()) {
+        return;
     }
+    
+    Move expected = result.pv[1];
+    MoveGenerator generator(*board_);
+    std::vector<Move> legalMoves = generator.generateLegalMoves(playerColor_);
+    if (std::find(legalMoves.begin(), legalMoves.end(), expected) == legalMoves.end()) {
+        return;
+    }
+    
+    ponderMove_ = expected;
+    ponderBoard_->setFromFEN(board_->toFEN());
+    ponderBoard_->makeMove(ponderMove_);
+    ponderEngine_->setDifficulty(aiEngine_->getDifficulty());
+    ponderFuture_ = ponderEngine_->startPondering(aiColor_, AI_MOVE_TIME_MS);
+    
+    qDebug() << "Пондеринг: ожидаем ход" << QString::fromStdString(ponderMove_.toLongAlgebraic());
+}
+
+void MainWindow::stopPondering() {
+    if (!ponderFuture_.valid()) {
+        return;
+    }
+    ponderEngine_->stop();
+    ponderFuture_.get();
+}
+
+void MainWindow::onAnalysisToggled(bool checked) {
+    if (!checked) {
+        stopAnalysis();
+        return;
+    }
+    
+    // Анализ идет на движке пондеринга: своя доска, общая таблица транспозиций
+    stopPondering();
+    ponderBoard_->setFromFEN(board_->toFEN());
+    ponderEngine_->startAnalysis(board_->position().sideToMove(), ANALYSIS_INTERVAL_MS);
+    analysisTimer_->start();
+    pvLabel_->setText("Анализ...");
+}
+
+void MainWindow::onAnalysisTimer() {
+    // Берем только самый свежий снимок, остальные устарели
+    AI::AnalysisSnapshot snapshot;
+    bool received = false;
+    while (ponderEngine_->pollAnalysis(snapshot)) {
+        received = true;
+    }
+    if (!received || snapshot.depth == 0) {
+        return;
+    }
+    
+    QStringList pvMoves;
+    for (const Move& move : snapshot.pv) {
+        pvMoves << QString::fromStdString(move.toLongAlgebraic());
+    }
+    int mateMoves = AI::mateInMoves(snapshot.score);
+    QString scoreText = (mateMoves != 0)
+        ? QString("мат в %1").arg(mateMoves)
+        : QString::number(snapshot.score);
+    pvLabel_->setText(QString("Анализ: глубина %1/%2, оценка %3, узлов %4 (%5 в сек), хеш %6‰: %7")
+        .arg(snapshot.depth)
+        .arg(snapshot.selDepth)
+        .arg(scoreText)
+        .arg(snapshot.nodes)
+        .arg(snapshot.nps)
+        .arg(snapshot.hashfull)
+        .arg(pvMoves.join(' ')));
+}
+
+void MainWindow::stopAnalysis() {
+    if (!ponderEngine_->isAnalyzing()) {
+        return;
+    }
+    analysisTimer_->stop();
+    ponderEngine_->stopAnalysis();
+    onAnalysisTimer();  // Итоговый снимок
+    
+    QSignalBlocker blocker(analysisButton_);
+    analysisButton_->setChecked(false);
 }
 
 void MainWindow::makeMove(const Move& move) {